@@ -41,7 +41,7 @@ CommandLineOptions::CommandLineOptions() : CommandLineOptions(0, nullptr) {}
 #endif
 
 CommandLineOptions::CommandLineOptions(int argc, const char* const* argv) :
-    autoSort(false) {
+    autoSort(false), sort(false) {
   // Record command line arguments.
   CefRefPtr<CefCommandLine> command_line = CefCommandLine::CreateCommandLine();
 
@@ -64,6 +64,7 @@ CommandLineOptions::CommandLineOptions(int argc, const char* const* argv) :
   }
 
   autoSort = command_line->HasSwitch("auto-sort");
+  sort = command_line->HasSwitch("sort");
 }
 
 LootApp::LootApp(CommandLineOptions options) :
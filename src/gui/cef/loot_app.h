@@ -40,6 +40,8 @@ struct CommandLineOptions {
   CommandLineOptions(int argc, const char *const *argv);
 
   bool autoSort;
+  // Sort without starting CEF, see RunHeadlessSort().
+  bool sort;
   std::string defaultGame;
   std::string lootDataPath;
 };
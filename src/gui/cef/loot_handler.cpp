@@ -148,7 +148,8 @@ void LootHandler::OnAfterCreated(CefRefPtr<CefBrowser> browser) {
   CefMessageRouterConfig config;
   browser_side_router_ = CefMessageRouterBrowserSide::Create(config);
 
-  browser_side_router_->AddHandler(new QueryHandler(lootState_), false);
+  queryHandler_ = std::make_unique<QueryHandler>(lootState_);
+  browser_side_router_->AddHandler(queryHandler_.get(), false);
 }
 
 bool LootHandler::DoClose(CefRefPtr<CefBrowser> browser) {
@@ -191,6 +192,10 @@ void LootHandler::OnBeforeClose(CefRefPtr<CefBrowser> browser) {
   // Cancel any javascript callbacks.
   browser_side_router_->OnBeforeClose(browser);
 
+  if (queryHandler_) {
+    queryHandler_->logQueryStats();
+  }
+
   // Remove from the list of existing browsers.
   for (BrowserList::iterator bit = browser_list_.begin();
        bit != browser_list_.end();
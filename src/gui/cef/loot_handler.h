@@ -27,10 +27,12 @@
 #define LOOT_GUI_LOOT_HANDLER
 
 #include <list>
+#include <memory>
 
 #include <include/cef_client.h>
 #include <include/wrapper/cef_message_router.h>
 
+#include "gui/cef/query/query_handler.h"
 #include "gui/state/loot_state.h"
 
 namespace loot {
@@ -109,6 +111,8 @@ private:
 
   // List of existing browser windows. Only accessed on the CEF UI thread.
   BrowserList browser_list_;
+  // Declared before the router so that it outlives the router.
+  std::unique_ptr<QueryHandler> queryHandler_;
   CefRefPtr<CefMessageRouterBrowserSide> browser_side_router_;
 
   LootState& lootState_;
@@ -0,0 +1,73 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_DEFERRED_QUERY
+#define LOOT_GUI_QUERY_DEFERRED_QUERY
+
+#include <functional>
+#include <memory>
+
+#include "gui/cef/query/query.h"
+
+namespace loot {
+// Creates the query that it wraps when it's executed instead of when it's
+// requested. Queries that use the current game need this, as they may be
+// queued behind a query that changes the current game, and the game that was
+// current when they were requested may no longer exist when they run.
+class DeferredQuery : public Query {
+public:
+  DeferredQuery(QueryAccess access,
+                std::function<std::unique_ptr<Query>()> createQuery) :
+      access_(access), createQuery_(createQuery) {}
+
+  std::string executeLogic() {
+    query_ = createQuery_();
+    query_->setCancellationToken(getCancellationToken());
+    if (canSendPartialResponses()) {
+      query_->setPartialResponseCallback(
+          [this](std::string response) { sendPartialResponse(response); });
+    }
+
+    return query_->executeLogic();
+  }
+
+  std::optional<std::string> getErrorMessage() {
+    if (query_) {
+      return query_->getErrorMessage();
+    }
+
+    return std::nullopt;
+  }
+
+  QueryAccess getAccess() { return access_; }
+
+private:
+  const QueryAccess access_;
+  const std::function<std::unique_ptr<Query>()> createQuery_;
+  std::unique_ptr<Query> query_;
+};
+}
+
+#endif
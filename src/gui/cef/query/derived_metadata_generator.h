@@ -0,0 +1,306 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_DERIVED_METADATA_GENERATOR
+#define LOOT_GUI_QUERY_DERIVED_METADATA_GENERATOR
+
+#include <exception>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/locale.hpp>
+
+#include "gui/cef/query/derived_plugin_metadata.h"
+#include "gui/state/cancellation_token.h"
+#include "gui/state/game/condition_cache.h"
+#include "gui/state/game/data_directory_index.h"
+#include "gui/state/game/derived_metadata_cache.h"
+#include "gui/state/game/helpers.h"
+#include "gui/state/logging.h"
+
+namespace loot {
+// Load order state that is read from the game once and then shared between
+// all the plugins that metadata is derived for.
+struct LoadOrderSnapshot {
+  // The loaded plugins, in load order.
+  std::vector<std::shared_ptr<const PluginInterface>> plugins;
+  // Only active plugins have indices, so this also records which are active.
+  LoadOrderIndexTable loadOrderIndices;
+  // Used to check that plugins' masters and requirements are installed.
+  std::shared_ptr<const DataDirectoryIndex> dataDirectoryIndex;
+  // Shared by all the plugins' install validity checks, as many plugins check
+  // the same files, e.g. the game's main master file.
+  std::shared_ptr<ConditionCache> conditionCache;
+  // The derived metadata cache's generation when the snapshot was taken.
+  uint64_t derivedMetadataGeneration = 0;
+};
+
+// Derives plugins' metadata in the same way for everything that needs it,
+// whether that's a query displaying it or a headless sort checking it for
+// errors.
+template<typename G = gui::Game>
+class DerivedMetadataGenerator {
+public:
+  DerivedMetadataGenerator(G& game, std::string language) :
+      game_(game), language_(language), logger_(getLogger()) {}
+
+  LoadOrderSnapshot GetLoadOrderSnapshot(
+      const std::vector<std::string>& loadOrder,
+      const CancellationToken& cancellationToken) const {
+    LoadOrderSnapshot snapshot;
+    snapshot.plugins.reserve(loadOrder.size());
+    for (const auto& pluginName : loadOrder) {
+      cancellationToken.ThrowIfCancelled();
+
+      auto plugin = game_.GetPlugin(pluginName);
+      if (plugin) {
+        snapshot.plugins.push_back(plugin);
+      }
+    }
+
+    snapshot.loadOrderIndices = game_.GetActiveLoadOrderIndices(loadOrder);
+    snapshot.dataDirectoryIndex = game_.IndexDataDirectory();
+    snapshot.conditionCache = std::make_shared<ConditionCache>();
+
+    auto& derivedMetadataCache = game_.GetDerivedMetadataCache();
+    derivedMetadataCache.SetContext(getDerivedMetadataContext(snapshot));
+    snapshot.derivedMetadataGeneration = derivedMetadataCache.GetGeneration();
+
+    return snapshot;
+  }
+
+  // Reads the plugin's active state and load order index from the game.
+  DerivedPluginMetadata<G> Generate(
+      const std::shared_ptr<const PluginInterface>& plugin) const {
+    auto isActive = game_.IsPluginActive(plugin->GetName());
+    auto loadOrderIndex =
+        game_.GetActiveLoadOrderIndex(plugin, game_.GetLoadOrder());
+
+    return generate(plugin, isActive, loadOrderIndex, nullptr);
+  }
+
+  DerivedPluginMetadata<G> Generate(
+      const std::shared_ptr<const PluginInterface>& plugin,
+      const LoadOrderSnapshot& snapshot) const {
+    auto loadOrderIndex =
+        snapshot.loadOrderIndices.GetIndex(plugin->GetName());
+
+    return generate(
+        plugin, loadOrderIndex.has_value(), loadOrderIndex, &snapshot);
+  }
+
+  std::optional<PluginMetadata> GetNonUserMetadata(
+      const std::shared_ptr<const PluginInterface>& file) const {
+    auto fileBashTags = file->GetBashTags();
+    auto masterlistMetadata = game_.GetMasterlistMetadata(file->GetName());
+
+    if (fileBashTags.empty()) {
+      return masterlistMetadata;
+    }
+
+    PluginMetadata metadata(file->GetName());
+    metadata.SetTags(fileBashTags);
+
+    if (masterlistMetadata.has_value()) {
+      masterlistMetadata.value().MergeMetadata(metadata);
+      return masterlistMetadata.value();
+    }
+
+    return metadata;
+  }
+
+private:
+  // Summarises everything apart from a plugin's own state and metadata that
+  // can affect its derived metadata: the response language, the installed
+  // files, which plugins are active (as install validity checks depend on
+  // these), and the state of the plugins and other files that the plugins'
+  // conditions and install validity checks read.
+  size_t getDerivedMetadataContext(const LoadOrderSnapshot& snapshot) const {
+    size_t context = 0;
+    boost::hash_combine(context, language_);
+    boost::hash_combine(context, snapshot.dataDirectoryIndex->GetFingerprint());
+    // Sorting changes load order indices without changing which plugins are
+    // active, so this ignores their order.
+    boost::hash_combine(
+        context, snapshot.loadOrderIndices.GetActivePluginsFingerprint());
+
+    auto metadataPaths = game_.GetMetadataPaths();
+
+    size_t readPluginsState = 0;
+    for (const auto& pluginName : metadataPaths->plugins) {
+      auto plugin = game_.GetPlugin(pluginName);
+      if (plugin) {
+        readPluginsState += getPluginState(*plugin);
+      }
+    }
+    boost::hash_combine(context, readPluginsState);
+    boost::hash_combine(context,
+                        snapshot.dataDirectoryIndex->GetFileStateFingerprint(
+                            metadataPaths->files));
+
+    return context;
+  }
+
+  static size_t getPluginState(const PluginInterface& plugin) {
+    size_t state = std::hash<std::string>()(plugin.GetName());
+    // Headers-only loads don't calculate CRCs, but the plugin cache keeps
+    // using the same plugin object while its file is unchanged.
+    auto crc = plugin.GetCRC();
+    if (crc.has_value()) {
+      boost::hash_combine(state, crc.value());
+    } else {
+      boost::hash_combine(state, &plugin);
+    }
+    boost::hash_combine(state, plugin.GetVersion().value_or(""));
+    boost::hash_combine(state, plugin.IsMaster());
+    boost::hash_combine(state, plugin.IsLightPlugin());
+
+    return state;
+  }
+
+  DerivedPluginMetadata<G> generate(
+      const std::shared_ptr<const PluginInterface>& plugin,
+      bool isActive,
+      std::optional<short> loadOrderIndex,
+      const LoadOrderSnapshot* snapshot) const {
+    auto derived =
+        DerivedPluginMetadata<G>(plugin, isActive, loadOrderIndex, language_);
+
+    auto nonUserMetadata = GetNonUserMetadata(plugin);
+    if (nonUserMetadata.has_value()) {
+      derived.setMasterlistMetadata(nonUserMetadata.value());
+    }
+
+    auto userMetadata = game_.GetUserMetadata(plugin->GetName());
+    if (userMetadata.has_value()) {
+      derived.setUserMetadata(userMetadata.value());
+    }
+
+    auto evaluatedMetadata = evaluateMetadata(plugin->GetName());
+    if (!evaluatedMetadata.has_value()) {
+      evaluatedMetadata = PluginMetadata(plugin->GetName());
+    }
+
+    auto messages = evaluatedMetadata.value().GetMessages();
+    auto validityMessages =
+        snapshot == nullptr
+            ? game_.CheckInstallValidity(plugin, evaluatedMetadata.value())
+            : game_.CheckInstallValidity(plugin,
+                                         evaluatedMetadata.value(),
+                                         *snapshot->dataDirectoryIndex,
+                                         *snapshot->conditionCache);
+    messages.insert(
+        end(messages), begin(validityMessages), end(validityMessages));
+    evaluatedMetadata.value().SetMessages(messages);
+
+    derived.setEvaluatedMetadata(evaluatedMetadata.value());
+
+    return derived;
+  }
+
+  std::optional<PluginMetadata> evaluateMetadata(
+      const std::string& pluginName) const {
+    auto evaluatedMasterlistMetadata = evaluateMasterlistMetadata(pluginName);
+    auto evaluatedUserMetadata = evaluateUserlistMetadata(pluginName);
+
+    if (!evaluatedMasterlistMetadata.has_value()) {
+      return evaluatedUserMetadata;
+    }
+
+    if (!evaluatedUserMetadata.has_value()) {
+      return evaluatedMasterlistMetadata;
+    }
+
+    evaluatedUserMetadata.value().MergeMetadata(
+        evaluatedMasterlistMetadata.value());
+
+    return evaluatedUserMetadata;
+  }
+
+  std::optional<PluginMetadata> evaluateMasterlistMetadata(
+      const std::string& pluginName) const {
+    try {
+      return game_.GetMasterlistMetadata(pluginName, true);
+    } catch (std::exception& e) {
+      if (logger_) {
+        logger_->error(
+            "\"{}\"'s masterlist metadata contains a condition that "
+            "could not be evaluated. Details: {}",
+            pluginName,
+            e.what());
+      }
+
+      PluginMetadata master(pluginName);
+      master.SetMessages({
+          PlainTextMessage(MessageType::error,
+                  (boost::format(boost::locale::translate(
+                       "\"%1%\" contains a condition that could not be "
+                       "evaluated. Details: %2%")) %
+                   pluginName % e.what())
+                      .str()),
+      });
+
+      return master;
+    }
+  }
+
+  std::optional<PluginMetadata> evaluateUserlistMetadata(
+      const std::string& pluginName) const {
+    try {
+      return game_.GetUserMetadata(pluginName, true);
+    } catch (std::exception& e) {
+      if (logger_) {
+        logger_->error(
+            "\"{}\"'s user metadata contains a condition that could "
+            "not be evaluated. Details: {}",
+            pluginName,
+            e.what());
+      }
+
+      PluginMetadata user(pluginName);
+      user.SetMessages({
+          PlainTextMessage(MessageType::error,
+                  (boost::format(boost::locale::translate(
+                       "\"%1%\" contains a condition that could not be "
+                       "evaluated. Details: %2%")) %
+                   pluginName % e.what())
+                      .str()),
+      });
+
+      return user;
+    }
+  }
+
+  G& game_;
+  const std::string language_;
+  std::shared_ptr<spdlog::logger> logger_;
+};
+}
+
+#endif
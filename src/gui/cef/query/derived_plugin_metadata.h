@@ -38,18 +38,19 @@ template<typename G>
 class DerivedPluginMetadata {
 public:
   DerivedPluginMetadata(const std::shared_ptr<const PluginInterface>& file,
-                        const G& game,
+                        bool isActive,
+                        std::optional<short> loadOrderIndex,
                         std::string language) :
       name(file->GetName()),
       version(file->GetVersion()),
-      isActive(game.IsPluginActive(file->GetName())),
+      isActive(isActive),
       isDirty(false),
       isEmpty(file->IsEmpty()),
       isMaster(file->IsMaster()),
       isLightPlugin(file->IsLightPlugin()),
       loadsArchive(file->LoadsArchive()),
       crc(file->GetCRC()),
-      loadOrderIndex(game.GetActiveLoadOrderIndex(file, game.GetLoadOrder())),
+      loadOrderIndex(loadOrderIndex),
       currentTags(file->GetBashTags()),
       language(language) {}
 
@@ -71,9 +72,7 @@ public:
     this->userMetadata = userlistEntry;
   }
 
-  void setLoadOrderIndex(short loadOrderIndex) {
-    this->loadOrderIndex = loadOrderIndex;
-  }
+  const std::vector<SimpleMessage>& getMessages() const { return messages; }
 
 private:
   std::string name;
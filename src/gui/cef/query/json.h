@@ -29,6 +29,8 @@ along with LOOT.  If not, see
 #undef min
 #undef max
 
+#include <functional>
+
 #include <json.hpp>
 #include <loot/api.h>
 
@@ -404,10 +406,6 @@ void to_json(nlohmann::json& json, const DerivedPluginMetadata<G>& plugin) {
     json["group"] = plugin.group.value();
   }
 
-  if (plugin.loadOrderIndex.has_value()) {
-    json["loadOrderIndex"] = plugin.loadOrderIndex.value();
-  }
-
   if (!plugin.cleanedWith.empty()) {
     json["cleanedWith"] = plugin.cleanedWith;
   }
@@ -419,6 +417,18 @@ void to_json(nlohmann::json& json, const DerivedPluginMetadata<G>& plugin) {
   if (plugin.userMetadata.has_value()) {
     json["userlist"] = to_json_with_language(plugin.userMetadata.value(), plugin.language);
   }
+
+  // The hash lets the frontend tell the backend which version of a plugin's
+  // metadata it has without sending the metadata. It excludes the load order
+  // index, which changes independently of the rest, and is truncated to 53
+  // bits so that it can be represented exactly as a JavaScript number.
+  static constexpr uint64_t MAX_SAFE_INTEGER = (uint64_t(1) << 53) - 1;
+  json["metadataHash"] =
+      uint64_t(std::hash<std::string>()(json.dump())) & MAX_SAFE_INTEGER;
+
+  if (plugin.loadOrderIndex.has_value()) {
+    json["loadOrderIndex"] = plugin.loadOrderIndex.value();
+  }
 }
 }
 
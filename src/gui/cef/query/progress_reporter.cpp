@@ -0,0 +1,121 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/cef/query/progress_reporter.h"
+
+#include <stdexcept>
+
+namespace loot {
+namespace {
+std::string getPhaseName(ProgressPhase phase) {
+  switch (phase) {
+    case ProgressPhase::loadingGameData:
+      return "loadingGameData";
+    case ProgressPhase::loadingPlugins:
+      return "loadingPlugins";
+    case ProgressPhase::evaluatingMetadata:
+      return "evaluatingMetadata";
+    case ProgressPhase::sortingPlugins:
+      return "sortingPlugins";
+    default:
+      throw std::invalid_argument("Unrecognised progress phase");
+  }
+}
+}
+
+ProgressUpdate::ProgressUpdate(ProgressPhase phase, std::string message) :
+    phase(phase), message(message) {}
+
+ProgressUpdate::ProgressUpdate(ProgressPhase phase,
+                               std::string message,
+                               size_t current,
+                               size_t total) :
+    phase(phase), message(message), current(current), total(total) {}
+
+bool ProgressUpdate::IsPhaseComplete() const {
+  return current.has_value() && total.has_value() &&
+         current.value() >= total.value();
+}
+
+void to_json(nlohmann::json& json, const ProgressUpdate& update) {
+  json = {
+      {"phase", getPhaseName(update.phase)},
+      {"message", update.message},
+  };
+
+  if (update.current.has_value()) {
+    json["current"] = update.current.value();
+  }
+
+  if (update.total.has_value()) {
+    json["total"] = update.total.value();
+  }
+}
+
+ProgressReporter::ProgressReporter(
+    ProgressCallback sink,
+    std::chrono::steady_clock::duration minInterval) :
+    sink_(sink), minInterval_(minInterval), droppedCount_(0) {}
+
+void ProgressReporter::Report(const ProgressUpdate& update) {
+  auto now = std::chrono::steady_clock::now();
+
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  if (!ShouldSend(update, now)) {
+    ++droppedCount_;
+    return;
+  }
+
+  // Send while holding the lock so that updates reach the sink in the order
+  // that they were accepted.
+  sink_(update);
+
+  lastSent_ = update;
+  lastSentTime_ = now;
+}
+
+size_t ProgressReporter::GetDroppedCount() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return droppedCount_;
+}
+
+bool ProgressReporter::ShouldSend(
+    const ProgressUpdate& update,
+    std::chrono::steady_clock::time_point now) const {
+  if (!lastSent_.has_value() || lastSent_.value().phase != update.phase) {
+    return true;
+  }
+
+  // Updates from worker threads can arrive out of order, and an update that
+  // is behind the last one sent would make progress appear to go backwards.
+  if (update.current.has_value() && lastSent_.value().current.has_value() &&
+      update.current.value() <= lastSent_.value().current.value()) {
+    return false;
+  }
+
+  return update.IsPhaseComplete() || now - lastSentTime_ >= minInterval_;
+}
+}
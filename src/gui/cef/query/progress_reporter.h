@@ -0,0 +1,97 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_PROGRESS_REPORTER
+#define LOOT_GUI_QUERY_PROGRESS_REPORTER
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#undef min
+#undef max
+#include <json.hpp>
+
+namespace loot {
+enum class ProgressPhase {
+  loadingGameData,
+  loadingPlugins,
+  evaluatingMetadata,
+  sortingPlugins,
+};
+
+// An update on the progress of a query. If the current phase processes a
+// known number of items, the update also gives how many have been processed.
+struct ProgressUpdate {
+  ProgressUpdate(ProgressPhase phase, std::string message);
+  ProgressUpdate(ProgressPhase phase,
+                 std::string message,
+                 size_t current,
+                 size_t total);
+
+  bool IsPhaseComplete() const;
+
+  ProgressPhase phase;
+  std::string message;
+  std::optional<size_t> current;
+  std::optional<size_t> total;
+};
+
+void to_json(nlohmann::json& json, const ProgressUpdate& update);
+
+typedef std::function<void(const ProgressUpdate&)> ProgressCallback;
+
+// Passes progress updates on to a sink without flooding it. An update is only
+// passed on if it starts a new phase, completes its phase, or is made at
+// least the minimum interval after the last update that was passed on. Other
+// updates are dropped, as are updates that arrive out of order, so the sink
+// only ever sees each phase's latest progress. Reporting is thread-safe.
+class ProgressReporter {
+public:
+  ProgressReporter(ProgressCallback sink,
+                   std::chrono::steady_clock::duration minInterval);
+
+  void Report(const ProgressUpdate& update);
+
+  size_t GetDroppedCount() const;
+
+private:
+  bool ShouldSend(const ProgressUpdate& update,
+                  std::chrono::steady_clock::time_point now) const;
+
+  const ProgressCallback sink_;
+  const std::chrono::steady_clock::duration minInterval_;
+
+  std::optional<ProgressUpdate> lastSent_;
+  std::chrono::steady_clock::time_point lastSentTime_;
+  size_t droppedCount_;
+
+  mutable std::mutex mutex_;
+};
+}
+
+#endif
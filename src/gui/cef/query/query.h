@@ -26,21 +26,66 @@ along with LOOT.  If not, see
 #ifndef LOOT_GUI_QUERY_QUERY
 #define LOOT_GUI_QUERY_QUERY
 
+#include <functional>
 #include <optional>
 #include <string>
 
 #include <boost/format.hpp>
 #include <boost/locale.hpp>
 
+#include "gui/state/cancellation_token.h"
 #include "gui/state/logging.h"
 #include "gui/state/loot_paths.h"
 #include "gui/state/loot_state.h"
 
 namespace loot {
+// How a query uses LOOT's state, which determines which other queries it can
+// run alongside.
+enum class QueryAccess {
+  // Only uses state that is internally synchronised, if any.
+  unsynchronised,
+  // Only reads state.
+  read,
+  // Modifies state.
+  write,
+};
+
 class Query {
 public:
+  virtual ~Query() = default;
+
   virtual std::string executeLogic() = 0;
   virtual std::optional<std::string> getErrorMessage() { return std::nullopt; };
+  virtual QueryAccess getAccess() { return QueryAccess::write; }
+
+  // Long-running queries check this token where it's safe for them to stop,
+  // and throw an OperationCancelledError if it has been cancelled.
+  CancellationToken getCancellationToken() const { return cancellationToken_; }
+  void setCancellationToken(const CancellationToken& cancellationToken) {
+    cancellationToken_ = cancellationToken;
+  }
+
+  // Persistent queries can respond more than once: the callback sends each
+  // part of the response that comes before the one executeLogic returns.
+  void setPartialResponseCallback(
+      std::function<void(std::string)> sendPartialResponse) {
+    sendPartialResponse_ = sendPartialResponse;
+  }
+
+protected:
+  bool canSendPartialResponses() const {
+    return static_cast<bool>(sendPartialResponse_);
+  }
+
+  void sendPartialResponse(std::string response) const {
+    if (sendPartialResponse_) {
+      sendPartialResponse_(response);
+    }
+  }
+
+private:
+  CancellationToken cancellationToken_;
+  std::function<void(std::string)> sendPartialResponse_;
 };
 
 template<typename G>
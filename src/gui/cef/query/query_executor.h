@@ -26,19 +26,29 @@ along with LOOT.  If not, see
 #ifndef LOOT_GUI_QUERY_QUERY_EXECUTOR
 #define LOOT_GUI_QUERY_QUERY_EXECUTOR
 
+#include <chrono>
+#include <functional>
+#include <mutex>
 #include <string>
 
 #include <include/wrapper/cef_message_router.h>
 #include <boost/locale.hpp>
 
 #include "gui/cef/query/query.h"
+#include "gui/cef/query/query_stats.h"
 #include "gui/state/logging.h"
 
 namespace loot {
 class QueryExecutor : public CefBaseRefCounted {
 public:
-  QueryExecutor(std::unique_ptr<Query> query) :
+  QueryExecutor(std::unique_ptr<Query> query,
+                bool persistent,
+                std::function<void(const QueryMeasurement&)> onExecuted) :
       query_(std::move(query)),
+      persistent_(persistent),
+      cancellationToken_(query_->getCancellationToken()),
+      onExecuted_(onExecuted),
+      creationTime_(std::chrono::steady_clock::now()),
       genericErrorMessage_(
           boost::locale::translate(
               "Oh no, something went wrong! You can check your "
@@ -46,23 +56,97 @@ public:
               "main menu) for more information.")
               .str()) {}
 
+  // Can be called from any thread. The query's callback is invalid once its
+  // query has been cancelled, so no response is sent after this is called.
+  void cancel() {
+    std::lock_guard<std::mutex> guard(callbackMutex_);
+    cancellationToken_.Cancel();
+  }
+
   void execute(CefRefPtr<CefMessageRouterBrowserSide::Callback> callback) {
+    executeQuery(callback);
+
+    // Release the query's data now instead of whenever the last reference to
+    // this executor is released.
+    query_.reset();
+  }
+
+private:
+  void executeQuery(
+      CefRefPtr<CefMessageRouterBrowserSide::Callback> callback) {
+    auto logger = getLogger();
+    if (cancellationToken_.IsCancelled()) {
+      if (logger) {
+        logger->debug("Skipping query that was cancelled before it started.");
+      }
+      return;
+    }
+
+    QueryMeasurement measurement;
+    auto startTime = std::chrono::steady_clock::now();
+    measurement.queueWait = startTime - creationTime_;
+
+    size_t partialResponsesSize = 0;
+    if (persistent_) {
+      query_->setPartialResponseCallback(
+          [this, callback, &partialResponsesSize](std::string response) {
+            partialResponsesSize += response.size();
+            sendSuccess(callback, response);
+          });
+    }
+
     try {
-      callback->Success(query_->executeLogic());
+      auto response = query_->executeLogic();
+
+      measurement.execution = std::chrono::steady_clock::now() - startTime;
+      measurement.responseSize = partialResponsesSize + response.size();
+      onExecuted_(measurement);
+
+      sendSuccess(callback, response);
+    } catch (OperationCancelledError& e) {
+      if (logger) {
+        logger->debug("Query was cancelled while it was running.");
+      }
+
+      sendFailure(callback, e.what());
     } catch (std::exception& e) {
-      auto logger = getLogger();
+      measurement.execution = std::chrono::steady_clock::now() - startTime;
+      measurement.responseSize = 0;
+      onExecuted_(measurement);
+
       if (logger) {
         logger->error("Exception while executing query: {}", e.what());
       }
 
-      callback->Failure(
-          -1, query_->getErrorMessage().value_or(genericErrorMessage_));
+      sendFailure(callback,
+                  query_->getErrorMessage().value_or(genericErrorMessage_));
     }
   }
 
-private:
-  const std::unique_ptr<Query> query_;
+  // The lock stops the query being cancelled while a response is being sent.
+  void sendSuccess(CefRefPtr<CefMessageRouterBrowserSide::Callback> callback,
+                   const std::string& response) {
+    std::lock_guard<std::mutex> guard(callbackMutex_);
+    if (!cancellationToken_.IsCancelled()) {
+      callback->Success(response);
+    }
+  }
+
+  void sendFailure(CefRefPtr<CefMessageRouterBrowserSide::Callback> callback,
+                   const std::string& errorMessage) {
+    std::lock_guard<std::mutex> guard(callbackMutex_);
+    if (!cancellationToken_.IsCancelled()) {
+      callback->Failure(-1, errorMessage);
+    }
+  }
+
+  std::unique_ptr<Query> query_;
+  const bool persistent_;
+  const CancellationToken cancellationToken_;
+  const std::function<void(const QueryMeasurement&)> onExecuted_;
+  const std::chrono::steady_clock::time_point creationTime_;
   const std::string genericErrorMessage_;
+  std::mutex callbackMutex_;
 
   IMPLEMENT_REFCOUNTING(QueryExecutor);
 };
@@ -25,18 +25,19 @@
 
 #include "gui/cef/query/query_handler.h"
 
+#include <chrono>
 #include <filesystem>
 #include <iomanip>
+#include <memory>
 #include <sstream>
 #include <string>
 
-#include <include/base/cef_bind.h>
 #include <include/cef_app.h>
-#include <include/cef_task.h>
-#include <include/wrapper/cef_closure_task.h>
 
 #include "gui/cef/loot_app.h"
 #include "gui/cef/loot_handler.h"
+#include "gui/cef/query/deferred_query.h"
+#include "gui/cef/query/progress_reporter.h"
 #include "gui/cef/query/query_executor.h"
 #include "gui/cef/query/types/apply_sort_query.h"
 #include "gui/cef/query/types/cancel_sort_query.h"
@@ -56,6 +57,7 @@
 #include "gui/cef/query/types/get_game_types_query.h"
 #include "gui/cef/query/types/get_init_errors_query.h"
 #include "gui/cef/query/types/get_installed_games_query.h"
+#include "gui/cef/query/types/get_query_stats_query.h"
 #include "gui/cef/query/types/get_settings_query.h"
 #include "gui/cef/query/types/get_themes_query.h"
 #include "gui/cef/query/types/get_version_query.h"
@@ -71,16 +73,57 @@
 #include <json.hpp>
 
 namespace loot {
-void sendProgressUpdate(CefRefPtr<CefFrame> frame, const std::string& message) {
+// Progress updates for a query are sent to the UI at most this often, apart
+// from updates that start or complete a phase of the query.
+constexpr std::chrono::milliseconds PROGRESS_UPDATE_INTERVAL(100);
+
+void sendProgressUpdate(CefRefPtr<CefFrame> frame,
+                        const ProgressUpdate& update) {
+  // The update is serialised as JSON, which is also a valid JavaScript
+  // expression, so no further escaping is needed.
+  auto json = nlohmann::json(update).dump();
+
   auto logger = getLogger();
   if (logger) {
-    logger->trace("Sending progress update: {}", message);
+    logger->trace("Sending progress update: {}", json);
   }
+
   frame->ExecuteJavaScript(
-      "loot.showProgress('" + message + "');", frame->GetURL(), 0);
+      "loot.onProgressUpdate(" + json + ");", frame->GetURL(), 0);
 }
 
-QueryHandler::QueryHandler(LootState& lootState) : lootState_(lootState) {}
+QueryHandler::QueryHandler(LootState& lootState) :
+    lootState_(lootState),
+    scheduler_(QueryScheduler::GetDefaultThreadCount()) {
+  registerQueries();
+}
+
+void QueryHandler::logQueryStats() const {
+  auto logger = getLogger();
+  if (!logger) {
+    return;
+  }
+
+  logger->info(
+      "Query statistics (times in milliseconds, sizes in bytes, given as "
+      "min / median / p99):");
+  for (const auto& [name, stats] : registry_.GetStats()) {
+    logger->info(
+        "{}: count {}, queue wait {:.1f} / {:.1f} / {:.1f}, execution "
+        "{:.1f} / {:.1f} / {:.1f}, response size {:.0f} / {:.0f} / {:.0f}",
+        name,
+        stats.executionMilliseconds.GetCount(),
+        stats.queueWaitMilliseconds.GetMin(),
+        stats.queueWaitMilliseconds.GetMedian(),
+        stats.queueWaitMilliseconds.GetPercentile(99),
+        stats.executionMilliseconds.GetMin(),
+        stats.executionMilliseconds.GetMedian(),
+        stats.executionMilliseconds.GetPercentile(99),
+        stats.responseBytes.GetMin(),
+        stats.responseBytes.GetMedian(),
+        stats.responseBytes.GetPercentile(99));
+  }
+}
 
 // Called due to cefQuery execution in binding.html.
 bool QueryHandler::OnQuery(CefRefPtr<CefBrowser> browser,
@@ -90,15 +133,43 @@ bool QueryHandler::OnQuery(CefRefPtr<CefBrowser> browser,
                            bool persistent,
                            CefRefPtr<Callback> callback) {
   try {
-    auto query = createQuery(browser, frame, request.ToString());
+    nlohmann::json json = nlohmann::json::parse(request.ToString());
+
+    const std::string name = json.at("name");
+
+    auto progressReporter = std::make_shared<ProgressReporter>(
+        [frame](const ProgressUpdate& update) {
+          sendProgressUpdate(frame, update);
+        },
+        PROGRESS_UPDATE_INTERVAL);
+
+    auto query = registry_.CreateQuery(
+        name, json, [progressReporter](const ProgressUpdate& update) {
+          progressReporter->Report(update);
+        });
 
     if (!query)
       return false;
 
-    CefRefPtr<QueryExecutor> executor = new QueryExecutor(std::move(query));
+    auto access = query->getAccess();
+    CefRefPtr<QueryExecutor> executor = new QueryExecutor(
+        std::move(query),
+        persistent,
+        [this, name](const QueryMeasurement& measurement) {
+          registry_.Record(name, measurement);
+        });
 
-    CefPostTask(TID_FILE,
-                base::Bind(&QueryExecutor::execute, executor, callback));
+    {
+      std::lock_guard<std::mutex> guard(pendingQueriesMutex_);
+      pendingQueries_.insert_or_assign(query_id, executor);
+    }
+
+    scheduler_.Schedule(access, [this, query_id, executor, callback]() {
+      executor->execute(callback);
+
+      std::lock_guard<std::mutex> guard(pendingQueriesMutex_);
+      pendingQueries_.erase(query_id);
+    });
   } catch (std::exception& e) {
     auto logger = getLogger();
     if (logger) {
@@ -112,106 +183,238 @@ bool QueryHandler::OnQuery(CefRefPtr<CefBrowser> browser,
   return true;
 }
 
-std::unique_ptr<Query> QueryHandler::createQuery(
-    CefRefPtr<CefBrowser> browser,
-    CefRefPtr<CefFrame> frame,
-    const std::string& requestString) {
-  nlohmann::json json = nlohmann::json::parse(requestString);
-
-  const std::string name = json.at("name");
-
-  if (name == "applySort") {
-    return std::make_unique<ApplySortQuery<>>(
-        lootState_.GetCurrentGame(), lootState_, json.at("pluginNames"));
-  } else if (name == "cancelSort") {
-    return std::make_unique<CancelSortQuery<>>(
-        lootState_.GetCurrentGame(), lootState_, lootState_.getLanguage());
-  } else if (name == "changeGame") {
-    return std::make_unique<ChangeGameQuery<>>(
-        lootState_,
-        lootState_.getLanguage(),
-        json.at("gameFolder"),
-        [frame](std::string message) { sendProgressUpdate(frame, message); });
-  } else if (name == "clearAllMetadata") {
-    return std::make_unique<ClearAllMetadataQuery<>>(lootState_.GetCurrentGame(),
-                                                   lootState_.getLanguage());
-  } else if (name == "clearPluginMetadata") {
-    return std::make_unique<ClearPluginMetadataQuery<>>(
-        lootState_.GetCurrentGame(),
-        lootState_.getLanguage(),
-        json.at("pluginName"));
-  } else if (name == "closeSettings") {
-    return std::make_unique<CloseSettingsQuery>(lootState_,
-                                                json.at("settings"));
-  } else if (name == "copyContent") {
-    return std::make_unique<CopyContentQuery>(json.at("content"));
-  } else if (name == "copyLoadOrder") {
-    return std::make_unique<CopyLoadOrderQuery<>>(lootState_.GetCurrentGame(),
-                                                json.at("pluginNames"));
-  } else if (name == "copyMetadata") {
-    return std::make_unique<CopyMetadataQuery<>>(lootState_.GetCurrentGame(),
-                                               lootState_.getLanguage(),
-                                               json.at("pluginName"));
-  } else if (name == "discardUnappliedChanges") {
-    return std::make_unique<DiscardUnappliedChangesQuery>(lootState_);
-  } else if (name == "editorClosed") {
-    return std::make_unique<EditorClosedQuery<>>(lootState_.GetCurrentGame(),
-                                               lootState_,
-                                               lootState_.getLanguage(),
-                                               json.at("editorState"));
-  } else if (name == "editorOpened") {
-    return std::make_unique<EditorOpenedQuery>(lootState_);
-  } else if (name == "getConflictingPlugins") {
-    return std::make_unique<GetConflictingPluginsQuery<>>(
-        lootState_.GetCurrentGame(),
-        lootState_.getLanguage(),
-        json.at("pluginName"));
-  } else if (name == "getGameTypes") {
-    return std::make_unique<GetGameTypesQuery>();
-  } else if (name == "getGameData") {
-    return std::make_unique<GetGameDataQuery<>>(
-        lootState_.GetCurrentGame(),
-        lootState_.getLanguage(),
-        [frame](std::string message) { sendProgressUpdate(frame, message); });
-  } else if (name == "getInitErrors") {
-    return std::make_unique<GetInitErrorsQuery>(lootState_);
-  } else if (name == "getInstalledGames") {
-    return std::make_unique<GetInstalledGamesQuery>(lootState_);
-  } else if (name == "getSettings") {
-    return std::make_unique<GetSettingsQuery>(lootState_);
-  } else if (name == "getThemes") {
-    return std::make_unique<GetThemesQuery>(lootState_.getResourcesPath());
-  } else if (name == "getVersion") {
-    return std::make_unique<GetVersionQuery>();
-  } else if (name == "openLogLocation") {
-    return std::make_unique<OpenLogLocationQuery>(lootState_.getLogPath());
-  } else if (name == "openReadme") {
-    return std::make_unique<OpenReadmeQuery>(
-        lootState_.getReadmePath(),
-        json.at("relativeFilePath").get<std::string>());
-  } else if (name == "redatePlugins") {
-    return std::make_unique<RedatePluginsQuery<>>(lootState_.GetCurrentGame());
-  } else if (name == "saveUserGroups") {
-    return std::make_unique<SaveUserGroupsQuery<>>(lootState_.GetCurrentGame(),
-                                                 json.at("userGroups"));
-  } else if (name == "saveFilterState") {
-    return std::make_unique<SaveFilterStateQuery>(
-        lootState_,
-        json.at("filter").at("name"),
-        json.at("filter").at("state"));
-  } else if (name == "sortPlugins") {
-    return std::make_unique<SortPluginsQuery<>>(
-        lootState_.GetCurrentGame(),
-        lootState_,
-        lootState_.getLanguage(),
-        [frame](std::string message) { sendProgressUpdate(frame, message); });
-  } else if (name == "updateMasterlist") {
-    return std::make_unique<UpdateMasterlistQuery<>>(lootState_.GetCurrentGame(),
-                                                   lootState_.getLanguage());
-  } else if (name == "getAutoSort") {
-    return std::make_unique<GetAutoSortQuery>(lootState_);
+void QueryHandler::OnQueryCanceled(CefRefPtr<CefBrowser> browser,
+                                   CefRefPtr<CefFrame> frame,
+                                   int64 query_id) {
+  std::lock_guard<std::mutex> guard(pendingQueriesMutex_);
+
+  auto it = pendingQueries_.find(query_id);
+  if (it == pendingQueries_.end()) {
+    return;
+  }
+
+  auto logger = getLogger();
+  if (logger) {
+    logger->debug("Cancelling query with ID {}.", query_id);
   }
 
-  return nullptr;
+  it->second->cancel();
+  pendingQueries_.erase(it);
+}
+
+void QueryHandler::registerQueries() {
+  // Queries that use the current game are created when they're executed, so
+  // that they get the game that's current then.
+  auto registerGameQuery = [this](const std::string& name,
+                                  QueryAccess access,
+                                  QueryRegistry::Factory factory) {
+    registry_.Register(
+        name,
+        [access, factory](const nlohmann::json& json,
+                          const ProgressCallback& sendProgressUpdate) {
+          return std::make_unique<DeferredQuery>(
+              access, [factory, json, sendProgressUpdate]() {
+                return factory(json, sendProgressUpdate);
+              });
+        });
+  };
+
+  registerGameQuery(
+      "applySort",
+      QueryAccess::write,
+      [this](const nlohmann::json& json, const ProgressCallback&) {
+        return std::make_unique<ApplySortQuery<>>(
+            lootState_.GetCurrentGame(), lootState_, json.at("pluginNames"));
+      });
+  registerGameQuery(
+      "cancelSort",
+      QueryAccess::write,
+      [this](const nlohmann::json&, const ProgressCallback&) {
+        return std::make_unique<CancelSortQuery<>>(
+            lootState_.GetCurrentGame(), lootState_, lootState_.getLanguage());
+      });
+  registry_.Register("changeGame",
+                     [this](const nlohmann::json& json,
+                            const ProgressCallback& sendProgressUpdate) {
+                       return std::make_unique<ChangeGameQuery<>>(
+                           lootState_,
+                           lootState_.getLanguage(),
+                           json.at("gameFolder"),
+                           sendProgressUpdate);
+                     });
+  registerGameQuery(
+      "clearAllMetadata",
+      QueryAccess::write,
+      [this](const nlohmann::json&, const ProgressCallback&) {
+        return std::make_unique<ClearAllMetadataQuery<>>(
+            lootState_.GetCurrentGame(), lootState_.getLanguage());
+      });
+  registerGameQuery(
+      "clearPluginMetadata",
+      QueryAccess::write,
+      [this](const nlohmann::json& json, const ProgressCallback&) {
+        return std::make_unique<ClearPluginMetadataQuery<>>(
+            lootState_.GetCurrentGame(),
+            lootState_.getLanguage(),
+            json.at("pluginName"));
+      });
+  registry_.Register(
+      "closeSettings",
+      [this](const nlohmann::json& json, const ProgressCallback&) {
+        return std::make_unique<CloseSettingsQuery>(lootState_,
+                                                    json.at("settings"));
+      });
+  registry_.Register(
+      "copyContent", [](const nlohmann::json& json, const ProgressCallback&) {
+        return std::make_unique<CopyContentQuery>(json.at("content"));
+      });
+  registerGameQuery(
+      "copyLoadOrder",
+      QueryAccess::read,
+      [this](const nlohmann::json& json, const ProgressCallback&) {
+        return std::make_unique<CopyLoadOrderQuery<>>(
+            lootState_.GetCurrentGame(), json.at("pluginNames"));
+      });
+  registerGameQuery(
+      "copyMetadata",
+      QueryAccess::read,
+      [this](const nlohmann::json& json, const ProgressCallback&) {
+        return std::make_unique<CopyMetadataQuery<>>(
+            lootState_.GetCurrentGame(),
+            lootState_.getLanguage(),
+            json.at("pluginName"));
+      });
+  registry_.Register(
+      "discardUnappliedChanges",
+      [this](const nlohmann::json&, const ProgressCallback&) {
+        return std::make_unique<DiscardUnappliedChangesQuery>(lootState_);
+      });
+  registerGameQuery(
+      "editorClosed",
+      QueryAccess::write,
+      [this](const nlohmann::json& json, const ProgressCallback&) {
+        return std::make_unique<EditorClosedQuery<>>(
+            lootState_.GetCurrentGame(),
+            lootState_,
+            lootState_.getLanguage(),
+            json.at("editorState"));
+      });
+  registry_.Register(
+      "editorOpened", [this](const nlohmann::json&, const ProgressCallback&) {
+        return std::make_unique<EditorOpenedQuery>(lootState_);
+      });
+  registry_.Register("getAutoSort",
+                     [this](const nlohmann::json&, const ProgressCallback&) {
+                       return std::make_unique<GetAutoSortQuery>(lootState_);
+                     });
+  registerGameQuery(
+      "getConflictingPlugins",
+      QueryAccess::write,
+      [this](const nlohmann::json& json,
+             const ProgressCallback& sendProgressUpdate) {
+        return std::make_unique<GetConflictingPluginsQuery<>>(
+            lootState_.GetCurrentGame(),
+            lootState_.getLanguage(),
+            json.at("pluginName"),
+            sendProgressUpdate);
+      });
+  registerGameQuery(
+      "getGameData",
+      QueryAccess::write,
+      [this](const nlohmann::json& json,
+             const ProgressCallback& sendProgressUpdate) {
+        return std::make_unique<GetGameDataQuery<>>(
+            lootState_.GetCurrentGame(),
+            lootState_.getLanguage(),
+            json.value("batchSize", size_t(0)),
+            sendProgressUpdate);
+      });
+  registry_.Register("getGameTypes",
+                     [](const nlohmann::json&, const ProgressCallback&) {
+                       return std::make_unique<GetGameTypesQuery>();
+                     });
+  registry_.Register("getInitErrors",
+                     [this](const nlohmann::json&, const ProgressCallback&) {
+                       return std::make_unique<GetInitErrorsQuery>(lootState_);
+                     });
+  registry_.Register(
+      "getInstalledGames",
+      [this](const nlohmann::json&, const ProgressCallback&) {
+        return std::make_unique<GetInstalledGamesQuery>(lootState_);
+      });
+  registry_.Register(
+      "getQueryStats", [this](const nlohmann::json&, const ProgressCallback&) {
+        return std::make_unique<GetQueryStatsQuery>(registry_);
+      });
+  registry_.Register("getSettings",
+                     [this](const nlohmann::json&, const ProgressCallback&) {
+                       return std::make_unique<GetSettingsQuery>(lootState_);
+                     });
+  registry_.Register(
+      "getThemes", [this](const nlohmann::json&, const ProgressCallback&) {
+        return std::make_unique<GetThemesQuery>(lootState_.getResourcesPath());
+      });
+  registry_.Register("getVersion",
+                     [](const nlohmann::json&, const ProgressCallback&) {
+                       return std::make_unique<GetVersionQuery>();
+                     });
+  registry_.Register(
+      "openLogLocation",
+      [this](const nlohmann::json&, const ProgressCallback&) {
+        return std::make_unique<OpenLogLocationQuery>(lootState_.getLogPath());
+      });
+  registry_.Register(
+      "openReadme",
+      [this](const nlohmann::json& json, const ProgressCallback&) {
+        return std::make_unique<OpenReadmeQuery>(
+            lootState_.getReadmePath(),
+            json.at("relativeFilePath").get<std::string>());
+      });
+  registerGameQuery(
+      "redatePlugins",
+      QueryAccess::write,
+      [this](const nlohmann::json&, const ProgressCallback&) {
+        return std::make_unique<RedatePluginsQuery<>>(
+            lootState_.GetCurrentGame());
+      });
+  registry_.Register(
+      "saveFilterState",
+      [this](const nlohmann::json& json, const ProgressCallback&) {
+        return std::make_unique<SaveFilterStateQuery>(
+            lootState_,
+            json.at("filter").at("name"),
+            json.at("filter").at("state"));
+      });
+  registerGameQuery(
+      "saveUserGroups",
+      QueryAccess::write,
+      [this](const nlohmann::json& json, const ProgressCallback&) {
+        return std::make_unique<SaveUserGroupsQuery<>>(
+            lootState_.GetCurrentGame(), json.at("userGroups"));
+      });
+  registerGameQuery(
+      "sortPlugins",
+      QueryAccess::write,
+      [this](const nlohmann::json& json,
+             const ProgressCallback& sendProgressUpdate) {
+        std::optional<SortPluginsQuery<>::MetadataHashes> metadataHashes;
+        if (json.contains("metadataHashes")) {
+          metadataHashes = json.at("metadataHashes");
+        }
+
+        return std::make_unique<SortPluginsQuery<>>(
+            lootState_.GetCurrentGame(),
+            lootState_,
+            lootState_.getLanguage(),
+            metadataHashes,
+            sendProgressUpdate);
+      });
+  registerGameQuery(
+      "updateMasterlist",
+      QueryAccess::write,
+      [this](const nlohmann::json&, const ProgressCallback&) {
+        return std::make_unique<UpdateMasterlistQuery<>>(
+            lootState_.GetCurrentGame(), lootState_.getLanguage());
+      });
 }
 }
@@ -26,9 +26,15 @@
 #ifndef LOOT_GUI_QUERY_HANDLER
 #define LOOT_GUI_QUERY_HANDLER
 
+#include <mutex>
+#include <unordered_map>
+
 #include <include/wrapper/cef_message_router.h>
 
 #include "gui/cef/query/query.h"
+#include "gui/cef/query/query_executor.h"
+#include "gui/cef/query/query_registry.h"
+#include "gui/cef/query/query_scheduler.h"
 #include "gui/state/loot_state.h"
 
 namespace loot {
@@ -36,6 +42,9 @@ class QueryHandler : public CefMessageRouterBrowserSide::Handler {
 public:
   QueryHandler(LootState& lootState);
 
+  // Writes a summary of the queries that have been run to the log.
+  void logQueryStats() const;
+
   // Called due to cefQuery execution in binding.html.
   virtual bool OnQuery(CefRefPtr<CefBrowser> browser,
                        CefRefPtr<CefFrame> frame,
@@ -44,12 +53,24 @@ public:
                        bool persistent,
                        CefRefPtr<Callback> callback) OVERRIDE;
 
-private:
-  std::unique_ptr<Query> createQuery(CefRefPtr<CefBrowser> browser,
+  // Called due to cefQueryCancel execution, or the browser closing.
+  virtual void OnQueryCanceled(CefRefPtr<CefBrowser> browser,
                                CefRefPtr<CefFrame> frame,
-                               const std::string& request);
+                               int64 query_id) OVERRIDE;
+
+private:
+  void registerQueries();
 
   LootState& lootState_;
+  QueryRegistry registry_;
+
+  // Queries that have been received but not yet finished, so that they can be
+  // cancelled.
+  std::unordered_map<int64, CefRefPtr<QueryExecutor>> pendingQueries_;
+  std::mutex pendingQueriesMutex_;
+
+  // Declared last so that it's destroyed first, as its tasks use the registry.
+  QueryScheduler scheduler_;
 };
 }
 
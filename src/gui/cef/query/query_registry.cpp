@@ -0,0 +1,57 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/cef/query/query_registry.h"
+
+namespace loot {
+void QueryRegistry::Register(const std::string& name, Factory factory) {
+  factories_.insert_or_assign(name, factory);
+}
+
+std::unique_ptr<Query> QueryRegistry::CreateQuery(
+    const std::string& name,
+    const nlohmann::json& request,
+    const ProgressCallback& sendProgressUpdate) const {
+  auto it = factories_.find(name);
+  if (it == factories_.end()) {
+    return nullptr;
+  }
+
+  return it->second(request, sendProgressUpdate);
+}
+
+void QueryRegistry::Record(const std::string& name,
+                           const QueryMeasurement& measurement) {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  stats_[name].Record(measurement);
+}
+
+std::map<std::string, QueryStats> QueryRegistry::GetStats() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  return std::map<std::string, QueryStats>(stats_.begin(), stats_.end());
+}
+}
@@ -0,0 +1,75 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_QUERY_REGISTRY
+#define LOOT_GUI_QUERY_QUERY_REGISTRY
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "gui/cef/query/progress_reporter.h"
+#include "gui/cef/query/query.h"
+#include "gui/cef/query/query_stats.h"
+
+#undef min
+#undef max
+#include <json.hpp>
+
+namespace loot {
+// Maps request names to the factories that create the queries that handle
+// them, and records measurements of each type of query.
+class QueryRegistry {
+public:
+  typedef std::function<std::unique_ptr<Query>(
+      const nlohmann::json& request,
+      const ProgressCallback& sendProgressUpdate)>
+      Factory;
+
+  void Register(const std::string& name, Factory factory);
+
+  // Returns nullptr if there is no query registered with the given name.
+  std::unique_ptr<Query> CreateQuery(
+      const std::string& name,
+      const nlohmann::json& request,
+      const ProgressCallback& sendProgressUpdate) const;
+
+  void Record(const std::string& name, const QueryMeasurement& measurement);
+
+  std::map<std::string, QueryStats> GetStats() const;
+
+private:
+  // Only modified while registering queries, so it's not guarded by mutex_.
+  std::unordered_map<std::string, Factory> factories_;
+  std::unordered_map<std::string, QueryStats> stats_;
+
+  mutable std::mutex mutex_;
+};
+}
+
+#endif
@@ -0,0 +1,144 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/cef/query/query_scheduler.h"
+
+#include <algorithm>
+
+#include "gui/state/logging.h"
+
+namespace loot {
+QueryScheduler::QueryScheduler(size_t threadCount) :
+    runningReadCount_(0), isWriteRunning_(false), isStopping_(false) {
+  for (size_t i = 0; i < std::max(threadCount, size_t(1)); ++i) {
+    threads_.emplace_back(&QueryScheduler::Work, this);
+  }
+}
+
+QueryScheduler::~QueryScheduler() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    isStopping_ = true;
+  }
+  taskStateChanged_.notify_all();
+
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void QueryScheduler::Schedule(QueryAccess access,
+                              std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    tasks_.push_back({access, task});
+  }
+  taskStateChanged_.notify_one();
+}
+
+size_t QueryScheduler::GetDefaultThreadCount() {
+  // Leave a thread free for unsynchronised tasks while a write runs, but
+  // don't use many more than that, as most queries are quick.
+  return std::clamp(std::thread::hardware_concurrency(), 2u, 4u);
+}
+
+std::optional<QueryScheduler::Task> QueryScheduler::TakeRunnableTask() {
+  // Only the first read or write task in the queue can be runnable, as they
+  // must start in order.
+  bool isSynchronisedTaskPending = false;
+  for (auto it = tasks_.begin(); it != tasks_.end(); ++it) {
+    bool isRunnable = false;
+    if (it->access == QueryAccess::unsynchronised) {
+      isRunnable = true;
+    } else if (!isSynchronisedTaskPending) {
+      isSynchronisedTaskPending = true;
+
+      if (it->access == QueryAccess::read) {
+        isRunnable = !isWriteRunning_;
+      } else {
+        isRunnable = !isWriteRunning_ && runningReadCount_ == 0;
+      }
+    }
+
+    if (isRunnable) {
+      auto task = std::move(*it);
+      tasks_.erase(it);
+      return task;
+    }
+  }
+
+  return std::nullopt;
+}
+
+void QueryScheduler::Work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (true) {
+    auto task = TakeRunnableTask();
+    if (!task.has_value()) {
+      if (isStopping_ && tasks_.empty()) {
+        return;
+      }
+
+      taskStateChanged_.wait(lock);
+      continue;
+    }
+
+    if (task->access == QueryAccess::read) {
+      ++runningReadCount_;
+    } else if (task->access == QueryAccess::write) {
+      isWriteRunning_ = true;
+    }
+
+    lock.unlock();
+    try {
+      task->function();
+    } catch (const std::exception& e) {
+      auto logger = getLogger();
+      if (logger) {
+        logger->error("Uncaught exception while running a query: {}",
+                      e.what());
+      }
+    } catch (...) {
+      // Anything else would end the thread, and the scheduler's state would
+      // then never be updated for the task finishing.
+      auto logger = getLogger();
+      if (logger) {
+        logger->error("Uncaught unknown exception while running a query.");
+      }
+    }
+    lock.lock();
+
+    if (task->access == QueryAccess::read) {
+      --runningReadCount_;
+    } else if (task->access == QueryAccess::write) {
+      isWriteRunning_ = false;
+    }
+
+    // Finishing a task may make several others runnable.
+    taskStateChanged_.notify_all();
+  }
+}
+}
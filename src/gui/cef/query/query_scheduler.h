@@ -0,0 +1,80 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_QUERY_SCHEDULER
+#define LOOT_GUI_QUERY_QUERY_SCHEDULER
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "gui/cef/query/query.h"
+
+namespace loot {
+// Runs tasks on a pool of threads according to how they access LOOT's state.
+// Tasks that read or write state run in the order they were scheduled:
+// consecutive reads can run alongside each other, but a write only runs once
+// all earlier tasks have finished, and blocks later reads and writes until it
+// finishes. Unsynchronised tasks run as soon as there's a free thread.
+class QueryScheduler {
+public:
+  explicit QueryScheduler(size_t threadCount);
+  // Waits for all scheduled tasks to finish.
+  ~QueryScheduler();
+
+  QueryScheduler(const QueryScheduler&) = delete;
+  QueryScheduler& operator=(const QueryScheduler&) = delete;
+
+  void Schedule(QueryAccess access, std::function<void()> task);
+
+  // Uses as many threads as the hardware can run concurrently, within limits.
+  static size_t GetDefaultThreadCount();
+
+private:
+  struct Task {
+    QueryAccess access;
+    std::function<void()> function;
+  };
+
+  // Must be called with mutex_ locked.
+  std::optional<Task> TakeRunnableTask();
+  void Work();
+
+  std::deque<Task> tasks_;
+  size_t runningReadCount_;
+  bool isWriteRunning_;
+  bool isStopping_;
+
+  std::mutex mutex_;
+  std::condition_variable taskStateChanged_;
+  std::vector<std::thread> threads_;
+};
+}
+
+#endif
@@ -0,0 +1,104 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/cef/query/query_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace loot {
+template<typename Duration>
+double toMilliseconds(Duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+MeasurementSeries::MeasurementSeries() :
+    count_(0), min_(0), nextRetainedIndex_(0) {}
+
+void MeasurementSeries::Add(double value) {
+  min_ = count_ == 0 ? value : std::min(min_, value);
+  ++count_;
+
+  if (retained_.size() < MAX_RETAINED_COUNT) {
+    retained_.push_back(value);
+  } else {
+    retained_[nextRetainedIndex_] = value;
+    nextRetainedIndex_ = (nextRetainedIndex_ + 1) % MAX_RETAINED_COUNT;
+  }
+}
+
+size_t MeasurementSeries::GetCount() const { return count_; }
+
+double MeasurementSeries::GetMin() const { return min_; }
+
+double MeasurementSeries::GetMedian() const { return GetPercentile(50); }
+
+double MeasurementSeries::GetPercentile(double percentile) const {
+  if (retained_.empty()) {
+    return 0;
+  }
+
+  // Use the nearest-rank method, so the result is always a measured value.
+  auto rank = static_cast<size_t>(
+      std::ceil(percentile / 100 * static_cast<double>(retained_.size())));
+  auto index = std::clamp(rank, size_t(1), retained_.size()) - 1;
+
+  auto values = retained_;
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+
+  return values[index];
+}
+
+QueryLatencyHistogram::QueryLatencyHistogram() : count_(0), buckets_({}) {}
+
+void QueryLatencyHistogram::Record(std::chrono::nanoseconds latency) {
+  size_t bucket = 0;
+  while (bucket < BUCKET_COUNT - 1 && latency >= GetBucketUpperBound(bucket)) {
+    ++bucket;
+  }
+
+  ++buckets_[bucket];
+  ++count_;
+}
+
+size_t QueryLatencyHistogram::GetCount() const { return count_; }
+
+const std::array<size_t, QueryLatencyHistogram::BUCKET_COUNT>&
+QueryLatencyHistogram::GetBuckets() const {
+  return buckets_;
+}
+
+std::chrono::milliseconds QueryLatencyHistogram::GetBucketUpperBound(
+    size_t bucket) {
+  return std::chrono::milliseconds(1ll << bucket);
+}
+
+void QueryStats::Record(const QueryMeasurement& measurement) {
+  queueWaitMilliseconds.Add(toMilliseconds(measurement.queueWait));
+  executionMilliseconds.Add(toMilliseconds(measurement.execution));
+  responseBytes.Add(static_cast<double>(measurement.responseSize));
+  executionHistogram.Record(measurement.execution);
+}
+}
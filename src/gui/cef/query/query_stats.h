@@ -0,0 +1,96 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_QUERY_STATS
+#define LOOT_GUI_QUERY_QUERY_STATS
+
+#include <array>
+#include <chrono>
+#include <vector>
+
+namespace loot {
+// How long a query waited to be run, how long it took to run and how large
+// its response was.
+struct QueryMeasurement {
+  std::chrono::nanoseconds queueWait;
+  std::chrono::nanoseconds execution;
+  size_t responseSize;
+};
+
+// Summarises a series of measurements. Only the most recent measurements are
+// kept for calculating percentiles, so that memory usage is bounded.
+class MeasurementSeries {
+public:
+  static constexpr size_t MAX_RETAINED_COUNT = 1000;
+
+  MeasurementSeries();
+
+  void Add(double value);
+
+  size_t GetCount() const;
+  // These all return 0 if there are no measurements.
+  double GetMin() const;
+  double GetMedian() const;
+  double GetPercentile(double percentile) const;
+
+private:
+  size_t count_;
+  double min_;
+  std::vector<double> retained_;
+  size_t nextRetainedIndex_;
+};
+
+// Counts query executions, bucketed by latency. Bucket i counts latencies
+// under 2^i milliseconds that don't fit in an earlier bucket, except for the
+// last bucket, which counts everything slower.
+class QueryLatencyHistogram {
+public:
+  static constexpr size_t BUCKET_COUNT = 16;
+
+  QueryLatencyHistogram();
+
+  void Record(std::chrono::nanoseconds latency);
+
+  size_t GetCount() const;
+  const std::array<size_t, BUCKET_COUNT>& GetBuckets() const;
+
+  static std::chrono::milliseconds GetBucketUpperBound(size_t bucket);
+
+private:
+  size_t count_;
+  std::array<size_t, BUCKET_COUNT> buckets_;
+};
+
+struct QueryStats {
+  void Record(const QueryMeasurement& measurement);
+
+  MeasurementSeries queueWaitMilliseconds;
+  MeasurementSeries executionMilliseconds;
+  MeasurementSeries responseBytes;
+  QueryLatencyHistogram executionHistogram;
+};
+}
+
+#endif
@@ -49,16 +49,12 @@ public:
         {"generalMessages", this->getGeneralMessages()},
     };
 
-    std::vector<std::string> loadOrder = this->getGame().GetLoadOrder();
-    for (const auto& pluginName : loadOrder) {
-      auto plugin = this->getGame().GetPlugin(pluginName);
-      if (!plugin) {
-        continue;
-      }
-
-      auto loadOrderIndex = this->getGame().GetActiveLoadOrderIndex(plugin, loadOrder);
+    auto snapshot = this->getLoadOrderSnapshot(this->getGame().GetLoadOrder());
+    for (const auto& plugin : snapshot.plugins) {
+      auto loadOrderIndex =
+          snapshot.loadOrderIndices.GetIndex(plugin->GetName());
 
-      nlohmann::json pluginJson = {{"name", pluginName}};
+      nlohmann::json pluginJson = {{"name", plugin->GetName()}};
       if (loadOrderIndex.has_value()) {
         pluginJson["loadOrderIndex"] = loadOrderIndex.value();
       }
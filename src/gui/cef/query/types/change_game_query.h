@@ -35,7 +35,7 @@ public:
   ChangeGameQuery(GamesManager& gamesManager,
                   std::string language,
                   std::string gameFolder,
-                  std::function<void(std::string)> sendProgressUpdate) :
+                  ProgressCallback sendProgressUpdate) :
       gamesManager_(gamesManager),
       gameFolder_(gameFolder),
       language_(language),
@@ -44,7 +44,9 @@ public:
   std::string executeLogic() {
     gamesManager_.SetCurrentGame(gameFolder_);
 
-    GetGameDataQuery<G> subQuery(gamesManager_.GetCurrentGame(), language_, sendProgressUpdate_);
+    GetGameDataQuery<G> subQuery(
+        gamesManager_.GetCurrentGame(), language_, 0, sendProgressUpdate_);
+    subQuery.setCancellationToken(this->getCancellationToken());
 
     return subQuery.executeLogic();
   }
@@ -53,7 +55,7 @@ private:
   GamesManager& gamesManager_;
   const std::string gameFolder_;
   const std::string language_;
-  const std::function<void(std::string)> sendProgressUpdate_;
+  const ProgressCallback sendProgressUpdate_;
 };
 }
 
@@ -77,10 +77,12 @@ private:
     nlohmann::json json;
 
     json["plugins"] = nlohmann::json::array();
+    auto snapshot = this->getLoadOrderSnapshot(this->getGame().GetLoadOrder());
     for (const auto& pluginName : userlistPluginNames) {
-      auto derivedMetadata = this->generateDerivedMetadata(pluginName);
-      if (derivedMetadata.has_value()) {
-        json["plugins"].push_back(derivedMetadata.value());
+      auto plugin = this->getGame().GetPlugin(pluginName);
+      if (plugin) {
+        json["plugins"].push_back(
+            this->generateDerivedMetadata(plugin, snapshot));
       }
     }
 
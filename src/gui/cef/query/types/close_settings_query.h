@@ -54,6 +54,9 @@ public:
     state_.updateMasterlist(settings_.value("updateMasterlist", true));
     state_.enableLootUpdateCheck(
         settings_.value("enableLootUpdateCheck", true));
+    state_.setInactiveGamesMemoryBudget(
+        settings_.value("inactiveGamesMemoryBudget",
+                        state_.getInactiveGamesMemoryBudget()));
     state_.storeGameSettings(
         settings_.value("games", std::vector<GameSettings>()));
 
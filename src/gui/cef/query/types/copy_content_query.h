@@ -45,6 +45,8 @@ public:
     return "";
   }
 
+  QueryAccess getAccess() { return QueryAccess::unsynchronised; }
+
 private:
   std::string getContentAsText() const {
     return content_.dump(4);
@@ -53,6 +53,8 @@ public:
     return "";
   }
 
+  QueryAccess getAccess() { return QueryAccess::read; }
+
 private:
   void writePluginLine(std::ostream& stream,
                        const std::string& pluginName,
@@ -75,6 +75,8 @@ public:
     return "";
   }
 
+  QueryAccess getAccess() { return QueryAccess::read; }
+
 private:
   std::string asText(const PluginMetadata& metadata) {
     return to_json_with_language(metadata, language_).dump(4);
@@ -51,6 +51,8 @@ public:
     return json.dump();
   }
 
+  QueryAccess getAccess() { return QueryAccess::unsynchronised; }
+
 private:
   const LootSettings& settings_;
 };
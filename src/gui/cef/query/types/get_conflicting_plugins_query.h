@@ -26,6 +26,8 @@ along with LOOT.  If not, see
 #ifndef LOOT_GUI_QUERY_GET_CONFLICTING_PLUGINS_QUERY
 #define LOOT_GUI_QUERY_GET_CONFLICTING_PLUGINS_QUERY
 
+#include <boost/locale.hpp>
+
 #include "gui/cef/query/json.h"
 #include "gui/cef/query/types/metadata_query.h"
 #include "gui/state/game/game.h"
@@ -36,8 +38,9 @@ class GetConflictingPluginsQuery : public MetadataQuery<G> {
 public:
   GetConflictingPluginsQuery(G& game,
                              std::string language,
-                             std::string pluginName) :
-      MetadataQuery<G>(game, language),
+                             std::string pluginName,
+                             ProgressCallback sendProgressUpdate) :
+      MetadataQuery<G>(game, language, sendProgressUpdate),
       pluginName_(pluginName) {}
 
   std::string executeLogic() {
@@ -48,10 +51,20 @@ public:
     }
 
     // Checking for FormID overlap will only work if the plugins have been
-    // loaded, so check if the plugins have been fully loaded, and if not load
-    // all plugins.
-    if (!this->getGame().ArePluginsFullyLoaded())
-      this->getGame().LoadAllInstalledPlugins(false);
+    // fully loaded, which may already be happening in the background, so only
+    // wait for whatever is left.
+    if (!this->getGame().ArePluginsFullyLoaded()) {
+      std::string message = boost::locale::translate("Loading plugins...");
+      this->getGame().WaitForFullyLoadedPlugins(
+          [&](size_t loadedCount, size_t totalCount) {
+            this->sendProgressUpdate(
+                ProgressUpdate(ProgressPhase::loadingPlugins,
+                               message,
+                               loadedCount,
+                               totalCount));
+          },
+          this->getCancellationToken());
+    }
 
     return getJsonResponse();
   }
@@ -60,7 +73,6 @@ private:
   std::string getJsonResponse() {
     nlohmann::json json = {
         {"generalMessages", this->getGeneralMessages()},
-        {"plugins", nlohmann::json::array()},
     };
 
     auto plugin = this->getGame().GetPlugin(pluginName_);
@@ -69,24 +81,21 @@ private:
                                "\" is not loaded.");
     }
 
-    for (const auto& otherPlugin : this->getGame().GetPlugins()) {
-      json["plugins"].push_back({
-          {"metadata", this->generateDerivedMetadata(otherPlugin)},
-          {"conflicts", doPluginsConflict(plugin, otherPlugin)},
-      });
-    }
-
-    return json.dump();
-  }
-
-  bool doPluginsConflict(
-      const std::shared_ptr<const PluginInterface>& plugin,
-      const std::shared_ptr<const PluginInterface>& otherPlugin) {
-    if (plugin->DoFormIDsOverlap(*otherPlugin)) {
-      return true;
-    } else {
-      return false;
-    }
+    auto snapshot = this->getLoadOrderSnapshot(this->getGame().GetLoadOrder());
+    auto overlappingPlugins = this->getGame().GetOverlappingPlugins(*plugin);
+
+    return this->generateJsonResponse(
+        json,
+        snapshot,
+        [&](const std::shared_ptr<const PluginInterface>& otherPlugin) {
+          return nlohmann::json({
+              {"metadata",
+               this->generateDerivedMetadata(otherPlugin, snapshot)},
+              {"conflicts",
+               overlappingPlugins->count(
+                   NormalizeFilename(otherPlugin->GetName())) > 0},
+          });
+        });
   }
 
   const std::string pluginName_;
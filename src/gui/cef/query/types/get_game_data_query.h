@@ -36,40 +36,76 @@ namespace loot {
 template<typename G = gui::Game>
 class GetGameDataQuery : public MetadataQuery<G> {
 public:
+  // If batchSize is non-zero and the query is persistent, plugins are sent in
+  // batches of that many as their metadata is derived, so that they can be
+  // displayed before all the plugins' metadata has been derived.
   GetGameDataQuery(G& game,
                    std::string language,
-                   std::function<void(std::string)> sendProgressUpdate) :
-      MetadataQuery<G>(game, language),
-      sendProgressUpdate_(sendProgressUpdate) {}
+                   size_t batchSize,
+                   ProgressCallback sendProgressUpdate) :
+      MetadataQuery<G>(game, language, sendProgressUpdate),
+      batchSize_(batchSize) {}
 
   std::string executeLogic() {
-    sendProgressUpdate_(boost::locale::translate(
-        "Parsing, merging and evaluating metadata..."));
-
-    /* If the game's plugins object is empty, this is the first time loading
-       the game data, so also load the metadata lists. */
-    bool isFirstLoad = this->getGame().GetPlugins().empty();
-
-    this->getGame().LoadAllInstalledPlugins(true);
-
-    if (isFirstLoad)
+    this->sendProgressUpdate(
+        ProgressUpdate(ProgressPhase::loadingGameData,
+                       boost::locale::translate(
+                           "Parsing, merging and evaluating metadata...")));
+
+    // Loading skips plugins and metadata lists that are unchanged since they
+    // were last loaded, so this is cheap for a game that was kept initialised
+    // while another game was current.
+    this->getGame().LoadAllInstalledPlugins(true,
+                                            this->getCancellationToken());
+
+    if (this->getGame().HaveMetadataListsChanged())
       this->getGame().LoadMetadata();
 
+    // Only plugin headers are needed to display the game's data, but some
+    // later queries need fully loaded plugins, so get a head start on them.
+    this->getGame().StartBackgroundFullLoad();
+
     // Sort plugins into their load order.
-    std::vector<std::shared_ptr<const PluginInterface>> installed;
-    std::vector<std::string> loadOrder = this->getGame().GetLoadOrder();
-    for (const auto& pluginName : loadOrder) {
-      const auto plugin = this->getGame().GetPlugin(pluginName);
-      if (plugin) {
-        installed.push_back(plugin);
-      }
+    auto snapshot = this->getLoadOrderSnapshot(this->getGame().GetLoadOrder());
+
+    if (batchSize_ == 0 || !this->canSendPartialResponses()) {
+      return this->generateJsonResponse(snapshot);
     }
 
-    return this->generateJsonResponse(installed.cbegin(), installed.cend());
+    return generateBatchedJsonResponses(snapshot);
   }
 
 private:
-  std::function<void(std::string)> sendProgressUpdate_;
+  // Each batch is a JSON object with "plugins" and "isLastBatch" fields. The
+  // first batch also holds the game's other data. All batches but the last
+  // are sent as partial responses, and the last is returned.
+  std::string generateBatchedJsonResponses(const LoadOrderSnapshot& snapshot) {
+    auto json = this->generateGameJson();
+    std::string lastBatch;
+
+    this->serialisePluginBatches(
+        snapshot,
+        batchSize_,
+        [&](const std::shared_ptr<const PluginInterface>& plugin) {
+          return this->serialiseDerivedMetadata(plugin, snapshot).json;
+        },
+        [&](std::vector<std::string>& pluginsJson, bool isLastBatch) {
+          json["isLastBatch"] = isLastBatch;
+          auto batch = this->appendPluginsArray(json, pluginsJson);
+
+          if (isLastBatch) {
+            lastBatch = std::move(batch);
+          } else {
+            this->sendPartialResponse(batch);
+          }
+
+          json = nlohmann::json::object();
+        });
+
+    return lastBatch;
+  }
+
+  const size_t batchSize_;
 };
 }
 
@@ -44,6 +44,8 @@ public:
     return getGameTypesAsJson();
   }
 
+  QueryAccess getAccess() { return QueryAccess::unsynchronised; }
+
 private:
   static std::string getGameTypesAsJson() {
     nlohmann::json json;
@@ -45,6 +45,8 @@ public:
     return json.dump();
   }
 
+  QueryAccess getAccess() { return QueryAccess::read; }
+
 private:
   const LootState& state_;
 };
@@ -47,6 +47,8 @@ public:
     return getInstalledGamesAsJson();
   }
 
+  QueryAccess getAccess() { return QueryAccess::unsynchronised; }
+
 private:
   std::string getInstalledGamesAsJson() const {
     nlohmann::json json;
@@ -0,0 +1,81 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_QUERY_GET_QUERY_STATS_QUERY
+#define LOOT_GUI_QUERY_GET_QUERY_STATS_QUERY
+
+#undef min
+
+#include <json.hpp>
+
+#include "gui/cef/query/query.h"
+#include "gui/cef/query/query_registry.h"
+
+namespace loot {
+class GetQueryStatsQuery : public Query {
+public:
+  GetQueryStatsQuery(const QueryRegistry& registry) : registry_(registry) {}
+
+  std::string executeLogic() {
+    auto logger = getLogger();
+    if (logger) {
+      logger->info("Getting query statistics.");
+    }
+
+    nlohmann::json queries = nlohmann::json::array();
+    for (const auto& [name, stats] : registry_.GetStats()) {
+      queries.push_back({
+          {"name", name},
+          {"count", stats.executionMilliseconds.GetCount()},
+          {"queueWaitMilliseconds", summarise(stats.queueWaitMilliseconds)},
+          {"executionMilliseconds", summarise(stats.executionMilliseconds)},
+          {"responseBytes", summarise(stats.responseBytes)},
+          {"executionHistogram", stats.executionHistogram.GetBuckets()},
+      });
+    }
+
+    nlohmann::json json = {
+        {"queries", queries},
+    };
+
+    return json.dump();
+  }
+
+  QueryAccess getAccess() { return QueryAccess::unsynchronised; }
+
+private:
+  static nlohmann::json summarise(const MeasurementSeries& series) {
+    return {
+        {"min", series.GetMin()},
+        {"median", series.GetMedian()},
+        {"p99", series.GetPercentile(99)},
+    };
+  }
+
+  const QueryRegistry& registry_;
+};
+}
+
+#endif
@@ -52,6 +52,8 @@ public:
         {"enableDebugLogging", settings_.isDebugLoggingEnabled()},
         {"updateMasterlist", settings_.updateMasterlist()},
         {"enableLootUpdateCheck", settings_.isLootUpdateCheckEnabled()},
+        {"inactiveGamesMemoryBudget",
+         settings_.getInactiveGamesMemoryBudget()},
         {"games", settings_.getGameSettings()},
         {"filters", settings_.getFilters()},
         {"languages", settings_.getLanguages()}
@@ -60,6 +62,8 @@ public:
     return json.dump();
   }
 
+  QueryAccess getAccess() { return QueryAccess::unsynchronised; }
+
 private:
   const LootSettings& settings_;
 };
@@ -50,6 +50,8 @@ public:
     return json.dump();
   }
 
+  QueryAccess getAccess() { return QueryAccess::unsynchronised; }
+
 private:
   std::vector<std::string> findThemes() const {
     std::vector<std::string> themes;
@@ -49,6 +49,8 @@ public:
 
     return json.dump();
   }
+
+  QueryAccess getAccess() { return QueryAccess::unsynchronised; }
 };
 }
 
@@ -26,11 +26,24 @@ along with LOOT.  If not, see
 #ifndef LOOT_GUI_QUERY_METADATA_QUERY
 #define LOOT_GUI_QUERY_METADATA_QUERY
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
 #include <boost/format.hpp>
 #include <boost/locale.hpp>
 
-#include "gui/cef/query/derived_plugin_metadata.h"
+#include "gui/cef/query/derived_metadata_generator.h"
+#include "gui/cef/query/progress_reporter.h"
 #include "gui/cef/query/query.h"
+#include "gui/state/game/derived_metadata_cache.h"
 #include "gui/state/game/helpers.h"
 #include "loot/exception/file_access_error.h"
 #include "loot/exception/git_state_error.h"
@@ -40,9 +53,24 @@ template<typename G = gui::Game>
 class MetadataQuery : public Query {
 protected:
   MetadataQuery(G& game, std::string language) :
+      MetadataQuery(game, language, nullptr) {}
+
+  // If given, sendProgressUpdate is also called as each plugin's metadata is
+  // derived.
+  MetadataQuery(G& game,
+                std::string language,
+                ProgressCallback sendProgressUpdate) :
       game_(game),
       language_(language),
-      logger_(getLogger()) {}
+      logger_(getLogger()),
+      sendProgressUpdate_(sendProgressUpdate),
+      generator_(game, language) {}
+
+  void sendProgressUpdate(const ProgressUpdate& update) const {
+    if (sendProgressUpdate_) {
+      sendProgressUpdate_(update);
+    }
+  }
 
   std::vector<SimpleMessage> getGeneralMessages() const {
     std::vector<Message> messages = game_.GetMessages();
@@ -52,22 +80,7 @@ protected:
 
   std::optional<PluginMetadata> getNonUserMetadata(
       const std::shared_ptr<const PluginInterface>& file) {
-    auto fileBashTags = file->GetBashTags();
-    auto masterlistMetadata = game_.GetMasterlistMetadata(file->GetName());
-
-    if (fileBashTags.empty()) {
-      return masterlistMetadata;
-    }
-
-    PluginMetadata metadata(file->GetName());
-    metadata.SetTags(fileBashTags);
-
-    if (masterlistMetadata.has_value()) {
-      masterlistMetadata.value().MergeMetadata(metadata);
-      return masterlistMetadata.value();
-    }
-
-    return metadata;
+    return generator_.GetNonUserMetadata(file);
   }
 
   std::optional<DerivedPluginMetadata<G>> generateDerivedMetadata(
@@ -82,33 +95,42 @@ protected:
 
   DerivedPluginMetadata<G> generateDerivedMetadata(
       const std::shared_ptr<const PluginInterface>& plugin) {
-    auto derived = DerivedPluginMetadata<G>(plugin, game_, language_);
+    return generator_.Generate(plugin);
+  }
 
-    auto nonUserMetadata = getNonUserMetadata(plugin);
-    if (nonUserMetadata.has_value()) {
-      derived.setMasterlistMetadata(nonUserMetadata.value());
-    }
+  DerivedPluginMetadata<G> generateDerivedMetadata(
+      const std::shared_ptr<const PluginInterface>& plugin,
+      const LoadOrderSnapshot& snapshot) {
+    return generator_.Generate(plugin, snapshot);
+  }
 
-    auto userMetadata = game_.GetUserMetadata(plugin->GetName());
-    if (userMetadata.has_value()) {
-      derived.setUserMetadata(userMetadata.value());
-    }
+  LoadOrderSnapshot getLoadOrderSnapshot(
+      const std::vector<std::string>& loadOrder) const {
+    return generator_.GetLoadOrderSnapshot(loadOrder,
+                                           this->getCancellationToken());
+  }
 
-    auto evaluatedMetadata = evaluateMetadata(plugin->GetName());
-    if (!evaluatedMetadata.has_value()) {
-      evaluatedMetadata = PluginMetadata(plugin->GetName());
+  // Gets the plugin's serialised derived metadata from the game's cache, or
+  // derives and serialises it and adds it to the cache.
+  DerivedMetadataCache::Entry serialiseDerivedMetadata(
+      const std::shared_ptr<const PluginInterface>& plugin,
+      const LoadOrderSnapshot& snapshot) {
+    auto& cache = game_.GetDerivedMetadataCache();
+    auto loadOrderIndex =
+        snapshot.loadOrderIndices.GetIndex(plugin->GetName());
+
+    auto cached = cache.Get(plugin, loadOrderIndex);
+    if (cached.has_value()) {
+      return cached.value();
     }
 
-    auto messages = evaluatedMetadata.value().GetMessages();
-    auto validityMessages =
-        game_.CheckInstallValidity(plugin, evaluatedMetadata.value());
-    messages.insert(
-        end(messages), begin(validityMessages), end(validityMessages));
-    evaluatedMetadata.value().SetMessages(messages);
+    auto json = nlohmann::json(generateDerivedMetadata(plugin, snapshot));
+    DerivedMetadataCache::Entry entry{json.dump(),
+                                      json.at("metadataHash").get<uint64_t>()};
+    cache.Set(
+        plugin, loadOrderIndex, entry, snapshot.derivedMetadataGeneration);
 
-    derived.setEvaluatedMetadata(evaluatedMetadata.value());
-
-    return derived;
+    return entry;
   }
 
   std::string generateJsonResponse(const std::string& pluginName) {
@@ -120,10 +142,9 @@ protected:
     return "";
   }
 
-  template<typename InputIterator>
-  std::string generateJsonResponse(InputIterator firstPlugin,
-                                   InputIterator lastPlugin) {
-    nlohmann::json json = {
+  // The game's data, apart from its plugins.
+  nlohmann::json generateGameJson() {
+    return {
         {"folder", game_.FolderName()},
         {"masterlist", getMasterlistInfo()},
         {"generalMessages", getGeneralMessages()},
@@ -133,14 +154,78 @@ protected:
              {"masterlist", game_.GetMasterlistGroups()},
              {"userlist", game_.GetUserGroups()},
          }},
-        {"plugins", nlohmann::json::array()},
     };
+  }
 
-    for (auto it = firstPlugin; it != lastPlugin; ++it) {
-      json["plugins"].push_back(generateDerivedMetadata(*it));
+  std::string generateJsonResponse(const LoadOrderSnapshot& snapshot) {
+    return generateJsonResponse(generateGameJson(), snapshot);
+  }
+
+  std::string generateJsonResponse(const nlohmann::json& json,
+                                   const LoadOrderSnapshot& snapshot) {
+    return generateJsonResponse(
+        json,
+        snapshot,
+        [&](const std::shared_ptr<const PluginInterface>& plugin) {
+          return serialiseDerivedMetadata(plugin, snapshot).json;
+        });
+  }
+
+  // Serialises the given JSON object with an added "plugins" array holding
+  // the JSON that serialisePlugin gives for each of the snapshot's plugins,
+  // which may be a JSON value or an already-serialised string. Empty strings
+  // are left out of the array.
+  // Each plugin is serialised as soon as its JSON object is created and that
+  // object is then discarded, and the results are appended in load order
+  // batches straight into the response and freed, so neither a JSON object
+  // for the whole response nor a second copy of its plugins is ever held.
+  template<typename Serialiser>
+  std::string generateJsonResponse(const nlohmann::json& json,
+                                   const LoadOrderSnapshot& snapshot,
+                                   Serialiser serialisePlugin) {
+    // Small enough that few serialised plugins are held at once, but big
+    // enough that the workers rarely wait for a batch to be appended.
+    static constexpr size_t RESPONSE_BATCH_SIZE = 64;
+
+    JsonResponseWriter writer(json, snapshot.plugins.size());
+    serialisePluginBatches(
+        snapshot,
+        RESPONSE_BATCH_SIZE,
+        serialisePlugin,
+        [&](std::vector<std::string>& pluginsJson, bool) {
+          writer.AppendPlugins(pluginsJson);
+        });
+
+    return std::move(writer).Finish();
+  }
+
+  // Serialises the snapshot's plugins in load order batches of up to
+  // batchSize plugins, passing each batch to sendBatch as soon as it has been
+  // serialised, along with whether it's the last batch. sendBatch is called
+  // once with an empty batch if there are no plugins.
+  template<typename Serialiser, typename BatchHandler>
+  void serialisePluginBatches(const LoadOrderSnapshot& snapshot,
+                              size_t batchSize,
+                              Serialiser serialisePlugin,
+                              BatchHandler sendBatch) {
+    if (batchSize == 0) {
+      throw std::invalid_argument("The batch size must be greater than zero");
     }
 
-    return json.dump();
+    serialisePlugins(snapshot.plugins, batchSize, serialisePlugin, sendBatch);
+
+    logSnapshotUsage(snapshot);
+  }
+
+  // Serialises the given JSON object with an added "plugins" array holding
+  // the given serialised plugins, without parsing them again. The plugins'
+  // strings are freed as they are appended.
+  static std::string appendPluginsArray(const nlohmann::json& json,
+                                        std::vector<std::string>& pluginsJson) {
+    JsonResponseWriter writer(json, pluginsJson.size());
+    writer.AppendPlugins(pluginsJson);
+
+    return std::move(writer).Finish();
   }
 
   G& getGame() {
@@ -152,91 +237,286 @@ protected:
   }
 
 private:
-  static std::vector<SimpleMessage> toSimpleMessages(
-      const std::vector<Message>& messages,
-      const std::string& language) {
-    std::vector<SimpleMessage> simpleMessages(messages.size());
-    std::transform(begin(messages),
-                   end(messages),
-                   begin(simpleMessages),
-                   [&](const Message& message) {
-                     return message.ToSimpleMessage(language);
-                   });
+  // Writes a JSON object with an added "plugins" array into a single buffer,
+  // with plugins' serialised JSON appended as it becomes available.
+  class JsonResponseWriter {
+  public:
+    JsonResponseWriter(const nlohmann::json& json, size_t pluginCount) :
+        response_(json.dump()),
+        pluginCount_(pluginCount),
+        appendedCount_(0),
+        reserved_(false) {
+      if (response_.empty() || response_.back() != '}') {
+        throw std::invalid_argument("The JSON response must be an object");
+      }
+      response_.pop_back();
 
-    return simpleMessages;
-  }
+      if (response_.size() > 1) {
+        response_ += ',';
+      }
+      response_ += PLUGINS_KEY;
+      pluginsStart_ = response_.size();
+    }
 
-  std::optional<PluginMetadata> evaluateMetadata(
-      const std::string& pluginName) {
-    auto evaluatedMasterlistMetadata = evaluateMasterlistMetadata(pluginName);
-    auto evaluatedUserMetadata = evaluateUserlistMetadata(pluginName);
+    // Empty strings are skipped. Each string is freed once it's appended.
+    void AppendPlugins(std::vector<std::string>& pluginsJson) {
+      for (auto& pluginJson : pluginsJson) {
+        if (!pluginJson.empty()) {
+          if (response_.size() > pluginsStart_) {
+            response_ += ',';
+          }
+          response_ += pluginJson;
+        }
+        std::string().swap(pluginJson);
+      }
+      appendedCount_ += pluginsJson.size();
 
-    if (!evaluatedMasterlistMetadata.has_value()) {
-      return evaluatedUserMetadata;
+      reserveForRemainingPlugins();
     }
 
-    if (!evaluatedUserMetadata.has_value()) {
-      return evaluatedMasterlistMetadata;
+    std::string Finish() && {
+      response_ += TAIL;
+      return std::move(response_);
     }
 
-    evaluatedUserMetadata.value().MergeMetadata(
-        evaluatedMasterlistMetadata.value());
+  private:
+    static constexpr std::string_view PLUGINS_KEY = "\"plugins\":[";
+    static constexpr std::string_view TAIL = "]}";
 
-    return evaluatedUserMetadata;
-  }
+    // Plugins' JSON is usually of a similar size, so after the first batch,
+    // grow the buffer once to fit the remaining plugins at the average size
+    // so far, instead of repeatedly doubling it.
+    void reserveForRemainingPlugins() {
+      if (reserved_ || appendedCount_ == 0 || appendedCount_ >= pluginCount_) {
+        return;
+      }
 
-  std::optional<PluginMetadata> evaluateMasterlistMetadata(
-      const std::string& pluginName) {
-    try {
-      return game_.GetMasterlistMetadata(pluginName, true);
-    } catch (std::exception& e) {
-      if (logger_) {
-        logger_->error(
-            "\"{}\"'s masterlist metadata contains a condition that "
-            "could not be evaluated. Details: {}",
-            pluginName,
-            e.what());
+      auto averageSize = (response_.size() - pluginsStart_) / appendedCount_;
+      auto remainingSize =
+          (averageSize + 1) * (pluginCount_ - appendedCount_) + TAIL.size();
+      response_.reserve(response_.size() + remainingSize);
+      reserved_ = true;
+    }
+
+    std::string response_;
+    size_t pluginsStart_;
+    const size_t pluginCount_;
+    size_t appendedCount_;
+    bool reserved_;
+  };
+
+  // Joins its threads when it is destroyed, after calling the given function
+  // to stop them taking any more work, so that they can't outlive the data
+  // they use even if starting a thread or the calling thread's work fails.
+  class WorkerThreads {
+  public:
+    explicit WorkerThreads(std::function<void()> stop) : stop_(stop) {}
+
+    ~WorkerThreads() {
+      stop_();
+      for (auto& thread : threads_) {
+        thread.join();
       }
+    }
 
-      PluginMetadata master(pluginName);
-      master.SetMessages({
-          PlainTextMessage(MessageType::error,
-                  (boost::format(boost::locale::translate(
-                       "\"%1%\" contains a condition that could not be "
-                       "evaluated. Details: %2%")) %
-                   pluginName % e.what())
-                      .str()),
-      });
-
-      return master;
+    // Returns the number of threads started, which may be fewer than the
+    // number requested if the system can't start any more.
+    template<typename Function>
+    size_t Start(size_t count, Function function) {
+      threads_.reserve(count);
+      try {
+        for (size_t i = 0; i < count; ++i) {
+          threads_.emplace_back(function);
+        }
+      } catch (const std::system_error&) {
+        // Carry on with the threads that were started.
+      }
+
+      return threads_.size();
     }
-  }
 
-  std::optional<PluginMetadata> evaluateUserlistMetadata(
-      const std::string& pluginName) {
-    try {
-      return game_.GetUserMetadata(pluginName, true);
-    } catch (std::exception& e) {
-      if (logger_) {
-        logger_->error(
-            "\"{}\"'s user metadata contains a condition that could "
-            "not be evaluated. Details: {}",
-            pluginName,
-            e.what());
+  private:
+    const std::function<void()> stop_;
+    std::vector<std::thread> threads_;
+  };
+
+  // Deriving a plugin's metadata involves evaluating its conditions and
+  // checking for the existence of files, so is spread across a bounded number
+  // of worker threads that are started once for all the plugins. Each
+  // plugin's output is written to its own slot, so the plugins stay in load
+  // order.
+  // The plugins are split into load order batches of up to batchSize plugins,
+  // and sendBatch is called on the current thread with each batch in order as
+  // soon as it has been serialised, along with whether it's the last batch,
+  // while the workers carry on with later batches. sendBatch is called once
+  // with an empty batch if there are no plugins.
+  template<typename Serialiser, typename BatchHandler>
+  void serialisePlugins(
+      const std::vector<std::shared_ptr<const PluginInterface>>& plugins,
+      size_t batchSize,
+      Serialiser serialisePlugin,
+      BatchHandler sendBatch) {
+    std::vector<std::string> pluginsJson(plugins.size());
+    auto batchCount = std::max((plugins.size() + batchSize - 1) / batchSize,
+                               size_t(1));
+
+    // The number of plugins that are still to be serialised in each batch.
+    std::vector<size_t> remainingCounts(batchCount, batchSize);
+    remainingCounts.back() = plugins.size() - (batchCount - 1) * batchSize;
+
+    auto cancellationToken = this->getCancellationToken();
+    std::atomic<size_t> nextIndex(0);
+    std::atomic<size_t> serialisedCount(0);
+    std::exception_ptr exception;
+    std::mutex mutex;
+    std::condition_variable pluginSerialised;
+
+    std::string progressMessage;
+    if (sendProgressUpdate_) {
+      progressMessage =
+          boost::locale::translate("Evaluating plugin metadata...").str();
+    }
+
+    // Returns false if there are no plugins left to serialise.
+    auto deriveNextPlugin = [&]() {
+      auto i = nextIndex++;
+      if (i >= plugins.size()) {
+        return false;
       }
 
-      PluginMetadata user(pluginName);
-      user.SetMessages({
-          PlainTextMessage(MessageType::error,
-                  (boost::format(boost::locale::translate(
-                       "\"%1%\" contains a condition that could not be "
-                       "evaluated. Details: %2%")) %
-                   pluginName % e.what())
-                      .str()),
-      });
-
-      return user;
+      try {
+        cancellationToken.ThrowIfCancelled();
+        pluginsJson[i] = toJsonString(serialisePlugin(plugins[i]));
+
+        if (sendProgressUpdate_) {
+          sendProgressUpdate_(ProgressUpdate(ProgressPhase::evaluatingMetadata,
+                                             progressMessage,
+                                             ++serialisedCount,
+                                             plugins.size()));
+        }
+
+        std::lock_guard<std::mutex> guard(mutex);
+        remainingCounts[i / batchSize] -= 1;
+      } catch (...) {
+        // Stop all workers from taking any more plugins.
+        nextIndex = plugins.size();
+
+        std::lock_guard<std::mutex> guard(mutex);
+        if (!exception) {
+          exception = std::current_exception();
+        }
+      }
+
+      pluginSerialised.notify_all();
+      return true;
+    };
+
+    WorkerThreads workers([&]() { nextIndex = plugins.size(); });
+    auto threadCount =
+        workers.Start(getWorkerThreadCount(plugins.size()) - 1, [&]() {
+          while (deriveNextPlugin()) {
+          }
+        }) +
+        1;
+    if (logger_) {
+      logger_->trace("Deriving metadata for {} plugins using {} threads.",
+                     plugins.size(),
+                     threadCount);
+    }
+
+    for (size_t batch = 0; batch < batchCount; ++batch) {
+      // The current thread does its share of the work too, and only waits
+      // once there are no plugins left for it to take.
+      std::unique_lock<std::mutex> lock(mutex);
+      while (remainingCounts[batch] > 0 && !exception) {
+        lock.unlock();
+        auto derivedPlugin = deriveNextPlugin();
+        lock.lock();
+
+        if (!derivedPlugin) {
+          pluginSerialised.wait(lock, [&]() {
+            return remainingCounts[batch] == 0 || exception;
+          });
+        }
+      }
+
+      if (exception) {
+        std::rethrow_exception(exception);
+      }
+      lock.unlock();
+
+      // Don't send any more batches once cancelled, even if they're ready.
+      cancellationToken.ThrowIfCancelled();
+
+      auto begin = batch * batchSize;
+      auto end = std::min(begin + batchSize, plugins.size());
+      std::vector<std::string> batchJson(
+          std::make_move_iterator(pluginsJson.begin() + begin),
+          std::make_move_iterator(pluginsJson.begin() + end));
+
+      sendBatch(batchJson, batch + 1 == batchCount);
+    }
+  }
+
+  static std::string toJsonString(const nlohmann::json& json) {
+    return json.dump();
+  }
+
+  static std::string toJsonString(std::string json) { return json; }
+
+  static size_t getWorkerThreadCount(size_t pluginCount) {
+    // Starting a thread costs more than deriving a few plugins' metadata, so
+    // don't give each thread less than this many plugins.
+    static constexpr size_t MIN_PLUGINS_PER_THREAD = 16;
+    static constexpr size_t MAX_THREADS = 8;
+
+    size_t hardwareThreads = std::thread::hardware_concurrency();
+    auto maxThreads = std::clamp(hardwareThreads, size_t(1), MAX_THREADS);
+    auto usefulThreads = pluginCount / MIN_PLUGINS_PER_THREAD;
+
+    return std::clamp(usefulThreads, size_t(1), maxThreads);
+  }
+
+  void logSnapshotUsage(const LoadOrderSnapshot& snapshot) const {
+    if (!logger_ || !snapshot.dataDirectoryIndex || !snapshot.conditionCache) {
+      return;
     }
+
+    logger_->debug(
+        "Checked for {} files in the data directory index of {} entries, "
+        "avoiding that many filesystem calls. {} paths could not be indexed "
+        "and were checked on the filesystem.",
+        snapshot.dataDirectoryIndex->GetIndexedLookupCount(),
+        snapshot.dataDirectoryIndex->GetEntryCount(),
+        snapshot.dataDirectoryIndex->GetFilesystemLookupCount());
+    logger_->debug(
+        "Install validity checks evaluated {} conditions, {} of which were "
+        "answered from the condition cache.",
+        snapshot.conditionCache->GetHitCount() +
+            snapshot.conditionCache->GetMissCount(),
+        snapshot.conditionCache->GetHitCount());
+
+    const auto& derivedMetadataCache = game_.GetDerivedMetadataCache();
+    logger_->debug(
+        "The derived metadata cache holds {} plugins, and has reused cached "
+        "metadata {} times and derived it {} times in total.",
+        derivedMetadataCache.Size(),
+        derivedMetadataCache.GetHitCount(),
+        derivedMetadataCache.GetMissCount());
+  }
+
+  static std::vector<SimpleMessage> toSimpleMessages(
+      const std::vector<Message>& messages,
+      const std::string& language) {
+    std::vector<SimpleMessage> simpleMessages(messages.size());
+    std::transform(begin(messages),
+                   end(messages),
+                   begin(simpleMessages),
+                   [&](const Message& message) {
+                     return message.ToSimpleMessage(language);
+                   });
+
+    return simpleMessages;
   }
 
   MasterlistInfo getMasterlistInfo() {
@@ -282,6 +562,8 @@ private:
   G& game_;
   std::shared_ptr<spdlog::logger> logger_;
   const std::string language_;
+  const ProgressCallback sendProgressUpdate_;
+  const DerivedMetadataGenerator<G> generator_;
 };
 }
 
@@ -45,6 +45,8 @@ public:
     return "";
   }
 
+  QueryAccess getAccess() { return QueryAccess::unsynchronised; }
+
 private:
   const std::filesystem::path logPath_;
 };
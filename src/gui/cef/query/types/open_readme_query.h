@@ -63,6 +63,8 @@ public:
     return "";
   }
 
+  QueryAccess getAccess() { return QueryAccess::unsynchronised; }
+
 private:
   const std::filesystem::path readmePath_;
   const std::string relativeFilePath_;
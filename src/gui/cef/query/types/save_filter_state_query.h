@@ -48,6 +48,8 @@ public:
     return "";
   }
 
+  QueryAccess getAccess() { return QueryAccess::unsynchronised; }
+
 private:
   LootSettings& settings_;
   const std::string filterId_;
@@ -26,6 +26,10 @@ along with LOOT.  If not, see
 #ifndef LOOT_GUI_QUERY_SORT_PLUGINS_QUERY
 #define LOOT_GUI_QUERY_SORT_PLUGINS_QUERY
 
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
 #include <boost/locale.hpp>
 
 #include "gui/cef/query/json.h"
@@ -37,12 +41,17 @@ namespace loot {
 template<typename G = gui::Game>
 class SortPluginsQuery : public MetadataQuery<G> {
 public:
+  typedef std::unordered_map<std::string, uint64_t> MetadataHashes;
+
+  // If the frontend's metadata hashes for its plugins are given, the response
+  // only includes metadata for plugins with different metadata hashes.
   SortPluginsQuery(G& game, UnappliedChangeCounter& counter,
                    std::string language,
-                   std::function<void(std::string)> sendProgressUpdate) :
-      MetadataQuery<G>(game, language),
+                   std::optional<MetadataHashes> knownMetadataHashes,
+                   ProgressCallback sendProgressUpdate) :
+      MetadataQuery<G>(game, language, sendProgressUpdate),
       counter_(counter),
-      sendProgressUpdate_(sendProgressUpdate) {}
+      knownMetadataHashes_(knownMetadataHashes) {}
 
   std::string executeLogic() {
     auto logger = getLogger();
@@ -51,7 +60,9 @@ public:
     }
 
     // Sort plugins into their load order.
-    sendProgressUpdate_(boost::locale::translate("Sorting load order..."));
+    this->sendProgressUpdate(
+        ProgressUpdate(ProgressPhase::sortingPlugins,
+                       boost::locale::translate("Sorting load order...")));
     std::vector<std::string> plugins = this->getGame().SortPlugins();
 
     try {
@@ -94,30 +105,58 @@ private:
   std::string generateJsonResponse(const std::vector<std::string>& plugins) {
     nlohmann::json json = {
         {"generalMessages", this->getGeneralMessages()},
-        {"plugins", nlohmann::json::array()},
     };
 
-    for (const auto& pluginName : plugins) {
-      auto plugin = this->getGame().GetPlugin(pluginName);
-      if (!plugin) {
-        continue;
-      }
+    auto snapshot = this->getLoadOrderSnapshot(plugins);
+
+    if (!knownMetadataHashes_.has_value()) {
+      return MetadataQuery<G>::generateJsonResponse(json, snapshot);
+    }
+
+    return generateDeltaJsonResponse(json, snapshot);
+  }
 
-      auto derivedMetadata = this->generateDerivedMetadata(plugin);
-      auto index =
-          this->getGame().GetActiveLoadOrderIndex(plugin, plugins);
-      if (index.has_value()) {
-        derivedMetadata.setLoadOrderIndex(index.value());
+  // Sorting usually only changes plugins' positions, so instead of every
+  // plugin's metadata, the response holds the new load order and the metadata
+  // of only those plugins that the frontend doesn't have up-to-date metadata
+  // for. Plugins with unchanged metadata serialise to an empty string and are
+  // left out.
+  std::string generateDeltaJsonResponse(nlohmann::json json,
+                                        const LoadOrderSnapshot& snapshot) {
+    const auto& knownMetadataHashes = knownMetadataHashes_.value();
+
+    auto loadOrder = nlohmann::json::array();
+    for (const auto& plugin : snapshot.plugins) {
+      nlohmann::json pluginJson = {{"name", plugin->GetName()}};
+
+      auto loadOrderIndex =
+          snapshot.loadOrderIndices.GetIndex(plugin->GetName());
+      if (loadOrderIndex.has_value()) {
+        pluginJson["loadOrderIndex"] = loadOrderIndex.value();
       }
 
-      json["plugins"].push_back(derivedMetadata);
+      loadOrder.push_back(pluginJson);
     }
-
-    return json.dump();
+    json["loadOrder"] = loadOrder;
+
+    return MetadataQuery<G>::generateJsonResponse(
+        json,
+        snapshot,
+        [&](const std::shared_ptr<const PluginInterface>& plugin) {
+          auto serialised = this->serialiseDerivedMetadata(plugin, snapshot);
+
+          auto it = knownMetadataHashes.find(plugin->GetName());
+          if (it != knownMetadataHashes.end() &&
+              serialised.metadataHash == it->second) {
+            return std::string();
+          }
+
+          return serialised.json;
+        });
   }
 
   UnappliedChangeCounter& counter_;
-  const std::function<void(std::string)> sendProgressUpdate_;
+  const std::optional<MetadataHashes> knownMetadataHashes_;
   std::optional<std::string> errorMessage;
 };
 }
@@ -45,8 +45,8 @@ public:
     if (!updateMasterlist())
       return "null";
 
-    auto plugins = this->getGame().GetPlugins();
-    return this->generateJsonResponse(plugins.cbegin(), plugins.cend());
+    auto snapshot = this->getLoadOrderSnapshot(this->getGame().GetLoadOrder());
+    return this->generateJsonResponse(snapshot);
   }
 
 private:
@@ -0,0 +1,215 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/headless_sort.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <boost/format.hpp>
+#include <boost/locale.hpp>
+
+#include "gui/cef/query/derived_metadata_generator.h"
+#include "gui/state/logging.h"
+#include "gui/state/loot_state.h"
+
+#undef min
+#undef max
+#include <json.hpp>
+
+namespace loot {
+namespace {
+std::string getMessageTypeName(MessageType type) {
+  switch (type) {
+    case MessageType::say:
+      return "say";
+    case MessageType::warn:
+      return "warn";
+    default:
+      return "error";
+  }
+}
+
+nlohmann::json toJson(const std::vector<Message>& messages,
+                      const std::string& language) {
+  auto json = nlohmann::json::array();
+  for (const auto& message : messages) {
+    auto simpleMessage = message.ToSimpleMessage(language);
+    json.push_back({
+        {"type", getMessageTypeName(simpleMessage.type)},
+        {"text", simpleMessage.text},
+    });
+  }
+
+  return json;
+}
+
+bool hasErrors(const std::vector<Message>& messages) {
+  return std::any_of(
+      messages.cbegin(), messages.cend(), [](const Message& message) {
+        return message.GetType() == MessageType::error;
+      });
+}
+
+// Derives each plugin's metadata in the same way as the UI does when
+// displaying it, so that plugin-level errors like missing masters or
+// requirements and incompatibilities are found.
+nlohmann::json getPluginErrors(gui::Game& game,
+                               const std::string& language,
+                               const std::vector<std::string>& loadOrder) {
+  DerivedMetadataGenerator<gui::Game> generator(game, language);
+
+  auto json = nlohmann::json::array();
+  auto snapshot =
+      generator.GetLoadOrderSnapshot(loadOrder, CancellationToken());
+  for (const auto& plugin : snapshot.plugins) {
+    auto derivedMetadata = generator.Generate(plugin, snapshot);
+    for (const auto& message : derivedMetadata.getMessages()) {
+      if (message.type == MessageType::error) {
+        json.push_back({
+            {"plugin", plugin->GetName()},
+            {"text", message.text},
+        });
+      }
+    }
+  }
+
+  return json;
+}
+
+// Follows the steps that the UI takes when auto-sorting: loading the game's
+// data, updating the masterlist if enabled, then sorting and applying the
+// sorted load order if nothing went wrong.
+void sortAndApply(LootState& state, nlohmann::json& json) {
+  auto logger = getLogger();
+  auto& game = state.GetCurrentGame();
+  json["game"] = game.FolderName();
+
+  game.LoadAllInstalledPlugins(true);
+  game.LoadMetadata();
+
+  if (state.updateMasterlist()) {
+    try {
+      game.UpdateMasterlist();
+    } catch (std::exception& e) {
+      if (logger) {
+        logger->error("Failed to update the masterlist. Details: {}",
+                      e.what());
+      }
+      // The UI doesn't sort if updating the masterlist fails.
+      json["errors"].push_back(
+          (boost::format(boost::locale::translate(
+               "Failed to update the masterlist. Details: %1%")) %
+           e.what())
+              .str());
+      return;
+    }
+  }
+
+  auto currentLoadOrder = game.GetLoadOrder();
+  auto sortedLoadOrder = game.SortPlugins();
+  auto messages = game.GetMessages();
+
+  json["loadOrder"] = sortedLoadOrder;
+  json["loadOrderChanged"] =
+      !sortedLoadOrder.empty() && sortedLoadOrder != currentLoadOrder;
+  json["messages"] = toJson(messages, state.getLanguage());
+  json["pluginErrors"] =
+      getPluginErrors(game, state.getLanguage(), sortedLoadOrder);
+
+  if (sortedLoadOrder.empty()) {
+    json["errors"].push_back(
+        boost::locale::translate("Failed to sort plugins.").str());
+    return;
+  }
+
+  // Like auto-sorting in the UI, don't apply the sorted load order if there
+  // are any error messages, as they may need fixing first.
+  if (hasErrors(messages) || !json["pluginErrors"].empty()) {
+    json["errors"].push_back(
+        boost::locale::translate("The sorted load order was not applied as "
+                                 "there is at least one error message.")
+            .str());
+    return;
+  }
+
+  game.SetLoadOrder(sortedLoadOrder);
+  json["applied"] = true;
+}
+}
+
+int RunHeadlessSort(const std::string& game,
+                    const std::filesystem::path& lootDataPath,
+                    std::ostream& out) {
+  auto startTime = std::chrono::steady_clock::now();
+
+  // stdout is used for the result, so keep any messages logged before the log
+  // file is set up out of it.
+  useStderrLogger();
+
+  nlohmann::json json = {
+      {"applied", false},
+      {"errors", nlohmann::json::array()},
+  };
+
+  if (game.empty()) {
+    json["errors"].push_back(
+        /* translators: --sort and --game are command-line arguments and
+           shouldn't be translated. */
+        boost::locale::translate(
+            "Error: --sort was passed but no --game parameter was provided.")
+            .str());
+  } else {
+    try {
+      LootState state("", lootDataPath);
+
+      // Sorting is done here instead of by the UI, so don't enable auto-sort.
+      state.init(game, false);
+      for (const auto& error : state.getInitErrors()) {
+        json["errors"].push_back(error);
+      }
+
+      if (json["errors"].empty()) {
+        sortAndApply(state, json);
+      }
+    } catch (std::exception& e) {
+      auto logger = getLogger();
+      if (logger) {
+        logger->error("Headless sort failed. Details: {}", e.what());
+      }
+      json["errors"].push_back(e.what());
+    }
+  }
+
+  auto elapsedTime = std::chrono::steady_clock::now() - startTime;
+  json["elapsedMilliseconds"] =
+      std::chrono::duration_cast<std::chrono::milliseconds>(elapsedTime)
+          .count();
+
+  out << json.dump() << std::endl;
+
+  return json["applied"].get<bool>() ? 0 : 1;
+}
+}
@@ -0,0 +1,47 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_HEADLESS_SORT
+#define LOOT_GUI_HEADLESS_SORT
+
+#include <filesystem>
+#include <ostream>
+#include <string>
+
+namespace loot {
+// Sorts the given game's load order and applies it without starting CEF, for
+// running LOOT from scripts. The result is written to out as a JSON object
+// with the game's folder name, the sorted load order, whether it was changed
+// and applied, the game's messages, plugins' error messages, any errors that
+// stopped the sorted load order being applied, and the time taken. As in the
+// UI, the sorted load order is not applied if there are any error messages.
+// Returns the process exit code: zero if the sorted load order was applied,
+// non-zero otherwise.
+int RunHeadlessSort(const std::string& game,
+                    const std::filesystem::path& lootDataPath,
+                    std::ostream& out);
+}
+
+#endif
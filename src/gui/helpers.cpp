@@ -159,6 +159,21 @@ int CompareFilenames(const std::string& lhs, const std::string& rhs) {
 #endif
 }
 
+std::string NormalizeFilename(const std::string& filename) {
+#ifdef _WIN32
+  // Use the same uppercase table information as CompareStringOrdinal.
+  auto wideString = ToWinWide(filename);
+  CharUpperBuffW(wideString.data(), static_cast<DWORD>(wideString.length()));
+  return FromWinWide(wideString);
+#else
+  std::string normalizedFilename;
+  UnicodeString::fromUTF8(filename)
+      .foldCase(U_FOLD_CASE_DEFAULT)
+      .toUTF8String(normalizedFilename);
+  return normalizedFilename;
+#endif
+}
+
 std::filesystem::path getExecutableDirectory() {
 #ifdef _WIN32
   // Despite its name, paths can be longer than MAX_PATH, just not by default.
@@ -26,6 +26,7 @@
 #define LOOT_GUI_HELPERS
 
 #include <filesystem>
+#include <string>
 
 namespace loot {
 void OpenInDefaultApplication(const std::filesystem::path& file);
@@ -46,6 +47,11 @@ std::string RegKeyStringValue(const std::string& rootKey,
 // locale-invariant.
 int CompareFilenames(const std::string& lhs, const std::string& rhs);
 
+// Normalise a filename so that two filenames that CompareFilenames considers to
+// be equal have equal normalised forms. This allows filenames to be used as
+// keys in hashed containers.
+std::string NormalizeFilename(const std::string& filename);
+
 std::filesystem::path getExecutableDirectory();
 
 std::filesystem::path getLocalAppDataPath();
@@ -1,10 +1,37 @@
 import { PaperDialogElement } from '@polymer/paper-dialog';
+import { PaperProgressElement } from '@polymer/paper-progress';
 import { PaperToastElement } from '@polymer/paper-toast';
 import LootMessageDialog from '../elements/loot-message-dialog';
 import { getElementById } from './dom/helpers';
 
+export interface ProgressUpdate {
+  phase: string;
+  message: string;
+  current?: number;
+  total?: number;
+}
+
+function setProgressBar(
+  progressDialog: PaperDialogElement,
+  current?: number,
+  total?: number
+): void {
+  const progressBar = progressDialog.getElementsByTagName(
+    'paper-progress'
+  )[0] as PaperProgressElement;
+
+  if (current === undefined || total === undefined || total === 0) {
+    progressBar.indeterminate = true;
+  } else {
+    progressBar.indeterminate = false;
+    progressBar.max = total;
+    progressBar.value = current;
+  }
+}
+
 export function showProgress(text: string): void {
   const progressDialog = getElementById('progressDialog') as PaperDialogElement;
+  setProgressBar(progressDialog);
   progressDialog.getElementsByTagName('p')[0].textContent = text;
   if (!progressDialog.opened) {
     progressDialog.open();
@@ -13,6 +40,13 @@ export function showProgress(text: string): void {
   }
 }
 
+export function showProgressUpdate(update: ProgressUpdate): void {
+  showProgress(update.message);
+
+  const progressDialog = getElementById('progressDialog') as PaperDialogElement;
+  setProgressBar(progressDialog, update.current, update.total);
+}
+
 export function closeProgress(): void {
   const progressDialog = getElementById('progressDialog') as PaperDialogElement;
   if (progressDialog.opened) {
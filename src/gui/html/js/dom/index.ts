@@ -211,6 +211,9 @@ export function updateSettingsDialog(settings: LootSettings): void {
   (
     getElementById('enableLootUpdateCheck') as PaperToggleButtonElement
   ).checked = settings.enableLootUpdateCheck;
+
+  (getElementById('inactiveGamesMemoryBudget') as PaperInputElement).value =
+    settings.inactiveGamesMemoryBudget.toString();
 }
 
 export function fillGameTypesList(gameTypes: string[]): void {
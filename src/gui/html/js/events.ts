@@ -32,7 +32,7 @@ import {
   sortPlugins,
   cancelSort,
   clearAllMetadata,
-  getGameData,
+  getGameDataInBatches,
   closeSettings,
   saveUserGroups,
   editorClosed,
@@ -50,10 +50,10 @@ import {
   copyMetadata
 } from './query';
 import {
-  DerivedPluginMetadata,
   FilterStates,
   GameContent,
-  LootSettings
+  LootSettings,
+  PluginLoadOrderIndex
 } from './interfaces';
 import LootGroupsEditor from '../elements/loot-groups-editor';
 import LootPluginCard from '../elements/loot-plugin-card';
@@ -360,8 +360,8 @@ export function onUpdateMasterlist(): void {
   Don't count removed invalid plugins as changing the load order.
 */
 function hasLoadOrderChanged(
-  oldLoadOrder: DerivedPluginMetadata[],
-  newLoadOrder: DerivedPluginMetadata[]
+  oldLoadOrder: PluginLoadOrderIndex[],
+  newLoadOrder: PluginLoadOrderIndex[]
 ): boolean {
   if (oldLoadOrder.length !== newLoadOrder.length) {
     return true;
@@ -404,14 +404,23 @@ export async function onSortPlugins(): Promise<void> {
       await updateMasterlist();
     }
 
-    const result = await sortPlugins();
+    /* Send the hashes of the plugins' current metadata so that only changed
+       metadata is sent back. */
+    const metadataHashes: Record<string, number> = {};
+    currentGame.plugins.forEach(plugin => {
+      if (plugin.metadataHash !== undefined) {
+        metadataHashes[plugin.name] = plugin.metadataHash;
+      }
+    });
+
+    const result = await sortPlugins(metadataHashes);
     if (!result) {
       return;
     }
 
     currentGame.generalMessages = result.generalMessages;
 
-    if (!result.plugins || result.plugins.length === 0) {
+    if (!result.loadOrder || result.loadOrder.length === 0) {
       const message = result.generalMessages.find(item =>
         item.text.startsWith(
           window.loot.l10n.translate('Cyclic interaction detected')
@@ -431,12 +440,12 @@ export async function onSortPlugins(): Promise<void> {
     /* Check if sorted load order differs from current load order. */
     const loadOrderIsUnchanged = !hasLoadOrderChanged(
       currentGame.plugins,
-      result.plugins
+      result.loadOrder
     );
 
     /* Set sorted plugins even if the load order hasn't changed because
          plugin metadata may have been updated. */
-    currentGame.setSortedPlugins(result.plugins);
+    currentGame.setSortedLoadOrder(result.loadOrder, result.plugins);
     if (loadOrderIsUnchanged) {
       /* Immediately 'apply' the load order to forget the 'old' load order. */
       currentGame.applySort();
@@ -609,12 +618,40 @@ export function onCopyLoadOrder(): void {
     .catch(handlePromiseError);
 }
 
+/* Plugins are displayed as soon as the first batch of them is received, and
+   the rest are added as they arrive. */
+const GAME_DATA_BATCH_SIZE = 100;
+
+export async function loadGameData(): Promise<Game> {
+  let game: Game | undefined;
+  await getGameDataInBatches(
+    GAME_DATA_BATCH_SIZE,
+    gameData => {
+      game = new Game(gameData, window.loot.l10n);
+      window.loot.game = game;
+      game.initialiseUI(window.loot.filters);
+
+      closeProgress();
+    },
+    plugins => {
+      if (game !== undefined) {
+        game.appendPlugins(plugins, window.loot.filters);
+      }
+    }
+  );
+
+  if (game === undefined) {
+    throw new Error('Failed to load game');
+  }
+
+  return game;
+}
+
 export function onContentRefresh(): void {
   /* Send a query for updated load order and plugin header info. */
-  getGameData()
-    .then(result => {
-      window.loot.game = new Game(result, window.loot.l10n);
-      window.loot.game.initialiseUI(window.loot.filters);
+  loadGameData()
+    .then(game => {
+      game.initialiseUI(window.loot.filters);
 
       closeProgress();
     })
@@ -917,6 +954,15 @@ export function onCloseSettingsDialog(evt: Event): void {
     enableLootUpdateCheck:
       (getElementById('enableLootUpdateCheck') as PaperCheckboxElement)
         .checked || false,
+    inactiveGamesMemoryBudget: Math.max(
+      0,
+      Math.floor(
+        Number(
+          (getElementById('inactiveGamesMemoryBudget') as PaperInputElement)
+            .value
+        )
+      ) || 0
+    ),
     filters: window.loot.settings.filters,
     lastVersion: window.loot.settings.lastVersion,
     languages: window.loot.settings.languages
@@ -374,20 +374,60 @@ export default class Game {
   }
 
   public setSortedPlugins(plugins: DerivedPluginMetadata[]): void {
+    this.setSortedLoadOrder(plugins, plugins);
+  }
+
+  /* Existing plugins that aren't in changedPlugins only have their load order
+     indices updated. */
+  public setSortedLoadOrder(
+    loadOrder: PluginLoadOrderIndex[],
+    changedPlugins: DerivedPluginMetadata[]
+  ): void {
+    const changedPluginsByName = new Map(
+      changedPlugins.map(plugin => [plugin.name, plugin])
+    );
+    const existingPluginsByName = new Map(
+      this.plugins.map(plugin => [plugin.name, plugin])
+    );
+
     this.oldLoadOrder = this.plugins;
 
-    this.plugins = plugins.map(plugin => {
-      const existingPlugin = this.oldLoadOrder.find(
-        item => item.name === plugin.name
-      );
-      if (existingPlugin) {
-        existingPlugin.update(plugin);
-        return existingPlugin;
+    this.plugins = loadOrder.map(item => {
+      const changedPlugin = changedPluginsByName.get(item.name);
+      const existingPlugin = existingPluginsByName.get(item.name);
+      if (existingPlugin === undefined) {
+        if (changedPlugin === undefined) {
+          throw new Error(`No metadata was received for ${item.name}`);
+        }
+        return new Plugin(changedPlugin);
       }
-      return new Plugin(plugin);
+
+      if (changedPlugin === undefined) {
+        existingPlugin.loadOrderIndex = item.loadOrderIndex;
+      } else {
+        existingPlugin.update(changedPlugin);
+      }
+      return existingPlugin;
     });
   }
 
+  /* Used to display plugins as their data is received, so only updates the
+     plugin lists. */
+  public appendPlugins(
+    plugins: DerivedPluginMetadata[],
+    filters: Filters
+  ): void {
+    this.plugins = this.plugins.concat(
+      plugins.map(plugin => new Plugin(plugin))
+    );
+
+    if (filters.areAnyFiltersActive()) {
+      filters.apply(this.plugins);
+    } else {
+      initialiseVirtualLists(this.plugins);
+    }
+  }
+
   public applySort(): void {
     this.oldLoadOrder = [];
   }
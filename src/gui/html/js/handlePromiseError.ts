@@ -1,7 +1,14 @@
 // Depends on the loot.l10n global.
 import { closeProgress, showMessage } from './dialog';
+import { QueryCancelledError } from './query';
 
 export default function handlePromiseError(error: Error): void {
+  /* Queries are only cancelled when superseded by another query, which is
+     responsible for the UI from then on. */
+  if (error instanceof QueryCancelledError) {
+    return;
+  }
+
   /* Error.stack seems to be Chromium-specific. */
   console.error(error.stack); // eslint-disable-line no-console
   closeProgress();
@@ -100,6 +100,7 @@ export interface DerivedPluginMetadata {
   cleanedWith?: string;
   masterlist?: PluginMetadata;
   userlist?: PluginMetadata;
+  metadataHash?: number;
 }
 
 export interface GameSettings {
@@ -134,6 +135,7 @@ export interface LootSettings {
   enableDebugLogging: boolean;
   updateMasterlist: boolean;
   enableLootUpdateCheck: boolean;
+  inactiveGamesMemoryBudget: number;
   filters: FilterStates;
 }
 
@@ -181,6 +183,12 @@ export interface MainContent {
   plugins: DerivedPluginMetadata[];
 }
 
+export interface SortedLoadOrder {
+  generalMessages: SimpleMessage[];
+  loadOrder: PluginLoadOrderIndex[];
+  plugins: DerivedPluginMetadata[];
+}
+
 export interface LootVersion {
   release: string;
   build: string;
@@ -52,9 +52,15 @@ import {
   onSettingsSelectGame,
   onSettingsAddGame,
   onSettingsDeleteGame,
-  onSettingsDeselectGame
+  onSettingsDeselectGame,
+  loadGameData
 } from './events';
-import { closeProgress, showProgress } from './dialog';
+import {
+  closeProgress,
+  ProgressUpdate,
+  showProgress,
+  showProgressUpdate
+} from './dialog';
 import {
   onOpenGroupsEditor,
   onGroupsEditorOpened,
@@ -86,7 +92,6 @@ import {
   getGameTypes,
   getInstalledGames,
   getSettings,
-  getGameData,
   getAutoSort,
   getThemes
 } from './query';
@@ -398,6 +403,9 @@ export default class Loot {
   // Used by C++ callbacks.
   public showProgress: (text: string) => void;
 
+  // Used by C++ callbacks.
+  public onProgressUpdate: (update: ProgressUpdate) => void;
+
   // Used by C++ callbacks.
   public onQuit: () => void;
 
@@ -412,6 +420,7 @@ export default class Loot {
     };
 
     this.showProgress = showProgress;
+    this.onProgressUpdate = showProgressUpdate;
     this.onQuit = onQuit;
   }
 
@@ -428,8 +437,7 @@ export default class Loot {
   }
 
   private async loadGameData(): Promise<void> {
-    const gameData = await getGameData();
-    this.game = new Game(gameData, this.l10n);
+    this.game = await loadGameData();
   }
 
   private async initialiseGeneralUIElements(): Promise<void> {
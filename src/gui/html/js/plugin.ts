@@ -346,6 +346,8 @@ export class Plugin {
 
   private _userlist?: PluginMetadata;
 
+  public metadataHash?: number;
+
   public id: string;
 
   private _isEditorOpen: boolean;
@@ -367,6 +369,7 @@ export class Plugin {
 
     this.masterlist = obj.masterlist;
     this._userlist = obj.userlist;
+    this.metadataHash = obj.metadataHash;
 
     this._group = obj.group || 'default';
     this._messages = obj.messages || [];
@@ -444,6 +447,8 @@ export class Plugin {
     } else {
       this.userlist = plugin.userlist;
     }
+
+    this.metadataHash = plugin.metadataHash;
   }
 
   public static tagFromRowData(rowData: TagRowData): Tag {
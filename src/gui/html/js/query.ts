@@ -4,7 +4,7 @@ import {
   DerivedPluginMetadata,
   LootSettings,
   GameData,
-  MainContent,
+  SortedLoadOrder,
   PluginLoadOrderIndex,
   GameGroups,
   RawGroup,
@@ -22,6 +22,14 @@ declare global {
 
   interface Window {
     cefQuery: (queryParameters: CefQueryParameters) => number;
+    cefQueryCancel: (queryId: number) => void;
+  }
+}
+
+export class QueryCancelledError extends Error {
+  public constructor(requestName: string) {
+    super(`The ${requestName} query was cancelled.`);
+    this.name = 'QueryCancelledError';
   }
 }
 
@@ -50,26 +58,121 @@ export interface ClearAllMetadataResponse {
   groups: GameGroups;
 }
 
-function query(
+/* Long-running queries whose results are made useless by later queries,
+   keyed by the names of the queries that supersede them. */
+const SUPERSEDED_QUERIES: Record<string, string[]> = {
+  changeGame: [
+    'changeGame',
+    'getConflictingPlugins',
+    'getGameData',
+    'sortPlugins',
+    'updateMasterlist'
+  ],
+  getConflictingPlugins: ['getConflictingPlugins']
+};
+
+interface PendingQuery {
+  requestName: string;
+  cancel: () => void;
+}
+
+const pendingQueries = new Map<number, PendingQuery>();
+
+function cancelSupersededQueries(requestName: string): void {
+  const supersededQueries = SUPERSEDED_QUERIES[requestName];
+  if (supersededQueries === undefined) {
+    return;
+  }
+
+  pendingQueries.forEach((pendingQuery, queryId) => {
+    if (supersededQueries.includes(pendingQuery.requestName)) {
+      pendingQueries.delete(queryId);
+      window.cefQueryCancel(queryId);
+      pendingQuery.cancel();
+    }
+  });
+}
+
+/* Sends a query and calls onResponse with each of its responses. Persistent
+   queries can respond more than once, so onResponse returns whether the
+   response it was given is the last one. */
+function sendQuery(
   requestName: string,
-  payload?: Record<string, unknown>
-): Promise<string> {
+  payload: Record<string, unknown> | undefined,
+  persistent: boolean,
+  onResponse: (response: string) => boolean
+): Promise<void> {
   if (!requestName) {
     throw new Error('No request name passed');
   }
 
+  cancelSupersededQueries(requestName);
+
   return new Promise((resolve, reject): void => {
-    window.cefQuery({
+    let isSettled = false;
+    let queryId: number | undefined;
+    const settle = (): void => {
+      isSettled = true;
+      if (queryId !== undefined) {
+        pendingQueries.delete(queryId);
+      }
+    };
+    // Persistent queries stay registered until they fail or are cancelled.
+    const settleAfterSuccess = (): void => {
+      settle();
+      if (persistent && queryId !== undefined) {
+        window.cefQueryCancel(queryId);
+      }
+    };
+
+    queryId = window.cefQuery({
       request: JSON.stringify({ name: requestName, ...payload }),
-      persistent: false,
-      onSuccess: resolve,
+      persistent,
+      onSuccess: response => {
+        if (isSettled) {
+          return;
+        }
+
+        try {
+          if (onResponse(response) || !persistent) {
+            settleAfterSuccess();
+            resolve();
+          }
+        } catch (error) {
+          settleAfterSuccess();
+          reject(error);
+        }
+      },
       onFailure: (_errorCode, errorMessage) => {
+        settle();
         reject(new Error(errorMessage));
       }
     });
+
+    // The query may have already been settled if it completed synchronously.
+    if (!isSettled) {
+      pendingQueries.set(queryId, {
+        requestName,
+        cancel: () => {
+          isSettled = true;
+          reject(new QueryCancelledError(requestName));
+        }
+      });
+    }
   });
 }
 
+function query(
+  requestName: string,
+  payload?: Record<string, unknown>
+): Promise<string> {
+  let result = '';
+  return sendQuery(requestName, payload, false, response => {
+    result = response;
+    return true;
+  }).then(() => result);
+}
+
 export function getVersion(): Promise<LootVersion> {
   return query('getVersion').then(JSON.parse);
 }
@@ -107,8 +210,26 @@ export function getThemes(): Promise<string[]> {
     .then(response => response.themes);
 }
 
-export function getGameData(): Promise<GameData> {
-  return query('getGameData').then(JSON.parse);
+/* Gets the game's data with its plugins split into batches that are sent as
+   their metadata is derived. The first batch holds the rest of the game's
+   data too. */
+export function getGameDataInBatches(
+  batchSize: number,
+  onFirstBatch: (gameData: GameData) => void,
+  onLaterBatch: (plugins: DerivedPluginMetadata[]) => void
+): Promise<void> {
+  let isFirstBatch = true;
+  return sendQuery('getGameData', { batchSize }, true, response => {
+    const batch = JSON.parse(response);
+    if (isFirstBatch) {
+      isFirstBatch = false;
+      onFirstBatch(batch);
+    } else {
+      onLaterBatch(batch.plugins);
+    }
+
+    return batch.isLastBatch !== false;
+  });
 }
 
 export async function getAutoSort(): Promise<boolean> {
@@ -124,8 +245,12 @@ export function updateMasterlist(): Promise<GameData> {
   return query('updateMasterlist').then(JSON.parse);
 }
 
-export function sortPlugins(): Promise<MainContent> {
-  return query('sortPlugins').then(JSON.parse);
+/* The response only includes metadata for plugins that have no metadata hash
+   in the given hashes, or a different hash. */
+export function sortPlugins(
+  metadataHashes: Record<string, number>
+): Promise<SortedLoadOrder> {
+  return query('sortPlugins', { metadataHashes }).then(JSON.parse);
 }
 
 export function cancelSort(): Promise<CancelSortResponse> {
@@ -540,6 +540,15 @@ function translateSettingsDialog(l10n: Translator): void {
   getPreviousElementSiblingById('enableLootUpdateCheck').textContent =
     l10n.translate('Check for LOOT updates on startup');
 
+  getElementById('inactiveGamesMemoryBudget').setAttribute(
+    'label',
+    l10n.translate('Memory for previously loaded games (MiB)')
+  );
+  getNextElementSiblingById('inactiveGamesMemoryBudget').textContent =
+    l10n.translate(
+      'Previously loaded games are kept in memory to make switching back to them faster, until they use more than this.'
+    );
+
   getElementById('settingsGameName').setAttribute(
     'error-message',
     l10n.translate('A name is required.')
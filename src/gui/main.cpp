@@ -23,7 +23,11 @@
     <https://www.gnu.org/licenses/>.
     */
 
+#include <iostream>
+
 #include "gui/cef/loot_app.h"
+#include "gui/headless_sort.h"
+#include "gui/state/logging.h"
 #include "gui/state/loot_paths.h"
 
 #ifdef _WIN32
@@ -59,6 +63,23 @@ CefSettings GetCefSettings(std::filesystem::path l10nPath) {
   return cef_settings;
 }
 
+#ifdef _WIN32
+// LOOT is a GUI application, so doesn't get a console of its own. If its
+// output hasn't been redirected, write it to the console of the process that
+// ran LOOT, if there is one.
+void AttachToParentConsole() {
+  if (GetFileType(GetStdHandle(STD_OUTPUT_HANDLE)) != FILE_TYPE_UNKNOWN) {
+    return;
+  }
+
+  if (AttachConsole(ATTACH_PARENT_PROCESS)) {
+    FILE *stream = nullptr;
+    freopen_s(&stream, "CONOUT$", "w", stdout);
+    freopen_s(&stream, "CONOUT$", "w", stderr);
+  }
+}
+#endif
+
 #ifndef _WIN32
 namespace {
 int XErrorHandlerImpl(Display *display, XErrorEvent *event) {
@@ -93,6 +114,16 @@ int APIENTRY wWinMain(HINSTANCE hInstance,
   CefMainArgs main_args(hInstance);
   const auto cliOptions = loot::CommandLineOptions();
 
+  // Sorting from the command line doesn't need a browser, so skip starting
+  // CEF and its sub-processes entirely.
+  if (cliOptions.sort) {
+    AttachToParentConsole();
+    auto exitCode = loot::RunHeadlessSort(
+        cliOptions.defaultGame, cliOptions.lootDataPath, std::cout);
+    loot::shutdownLogging();
+    return exitCode;
+  }
+
   // Create the process reference.
   CefRefPtr<loot::LootApp> app(new loot::LootApp(cliOptions));
 
@@ -134,6 +165,9 @@ int APIENTRY wWinMain(HINSTANCE hInstance,
   // Shut down CEF.
   CefShutdown();
 
+  // Write any log messages that are still queued.
+  loot::shutdownLogging();
+
   // Release the program instance mutex.
   if (hMutex != NULL) {
     ReleaseMutex(hMutex);
@@ -152,6 +186,15 @@ int main(int argc, char *argv[]) {
   CefMainArgs main_args(argc, argv);
   const auto cliOptions = loot::CommandLineOptions(argc, argv);
 
+  // Sorting from the command line doesn't need a browser, so skip starting
+  // CEF and its sub-processes entirely.
+  if (cliOptions.sort) {
+    auto exitCode = loot::RunHeadlessSort(
+        cliOptions.defaultGame, cliOptions.lootDataPath, std::cout);
+    loot::shutdownLogging();
+    return exitCode;
+  }
+
   // Create the process reference.
   CefRefPtr<loot::LootApp> app(new loot::LootApp(cliOptions));
 
@@ -180,6 +223,9 @@ int main(int argc, char *argv[]) {
   // Shut down CEF.
   CefShutdown();
 
+  // Write any log messages that are still queued.
+  loot::shutdownLogging();
+
   return 0;
 }
 #endif
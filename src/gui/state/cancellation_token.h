@@ -0,0 +1,63 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_CANCELLATION_TOKEN
+#define LOOT_GUI_STATE_CANCELLATION_TOKEN
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+namespace loot {
+class OperationCancelledError : public std::runtime_error {
+public:
+  OperationCancelledError() :
+      std::runtime_error("The operation was cancelled.") {}
+};
+
+// Lets one thread ask work being done by another to stop. Copies of a token
+// share its state, so cancelling one cancels them all.
+class CancellationToken {
+public:
+  CancellationToken() :
+      isCancelled_(std::make_shared<std::atomic<bool>>(false)) {}
+
+  void Cancel() const { *isCancelled_ = true; }
+
+  bool IsCancelled() const { return *isCancelled_; }
+
+  // Work should call this at points where it's safe to stop.
+  void ThrowIfCancelled() const {
+    if (IsCancelled()) {
+      throw OperationCancelledError();
+    }
+  }
+
+private:
+  std::shared_ptr<std::atomic<bool>> isCancelled_;
+};
+}
+
+#endif
@@ -0,0 +1,165 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/game/background_plugin_loader.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "gui/state/logging.h"
+
+namespace loot {
+// Small enough that cancellation is quick and progress is smooth, but large
+// enough for libloot to load each batch's plugins in parallel.
+static constexpr size_t PLUGINS_PER_BATCH = 64;
+
+static constexpr std::chrono::milliseconds CANCELLATION_POLL_INTERVAL(100);
+
+BackgroundPluginLoader::BackgroundPluginLoader(
+    GameType gameType,
+    const std::filesystem::path& gamePath,
+    const std::filesystem::path& gameLocalPath,
+    const std::string& masterFile,
+    const std::vector<std::string>& pluginNames) :
+    pluginNames_(pluginNames),
+    loadedPluginCount_(0),
+    finished_(false),
+    failed_(false),
+    cancelled_(false) {
+  thread_ = std::thread(&BackgroundPluginLoader::Load,
+                        this,
+                        gameType,
+                        gamePath,
+                        gameLocalPath,
+                        masterFile);
+}
+
+BackgroundPluginLoader::~BackgroundPluginLoader() {
+  Cancel();
+
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void BackgroundPluginLoader::Cancel() { cancelled_ = true; }
+
+bool BackgroundPluginLoader::IsFinished() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return finished_;
+}
+
+std::optional<std::vector<std::shared_ptr<const PluginInterface>>>
+BackgroundPluginLoader::Wait(const ProgressCallback& onProgress,
+                             const CancellationToken& cancellationToken) {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  auto reportedPluginCount = loadedPluginCount_;
+  onProgress(reportedPluginCount, pluginNames_.size());
+
+  while (!finished_) {
+    // Cancelling doesn't notify the condition variable, so poll for it.
+    progressed_.wait_for(lock, CANCELLATION_POLL_INTERVAL);
+    cancellationToken.ThrowIfCancelled();
+
+    if (loadedPluginCount_ != reportedPluginCount && !finished_) {
+      reportedPluginCount = loadedPluginCount_;
+
+      // Don't hold the lock while reporting progress, as it may be slow.
+      lock.unlock();
+      onProgress(reportedPluginCount, pluginNames_.size());
+      lock.lock();
+    }
+  }
+
+  if (failed_ || cancelled_) {
+    return std::nullopt;
+  }
+
+  return plugins_;
+}
+
+void BackgroundPluginLoader::Load(GameType gameType,
+                                  std::filesystem::path gamePath,
+                                  std::filesystem::path gameLocalPath,
+                                  std::string masterFile) {
+  auto logger = getLogger();
+  if (logger) {
+    logger->debug("Fully loading {} plugins in the background.",
+                  pluginNames_.size());
+  }
+
+  try {
+    auto gameHandle = CreateGameHandle(gameType, gamePath, gameLocalPath);
+    gameHandle->IdentifyMainMasterFile(masterFile);
+
+    for (auto batchStart = pluginNames_.begin();
+         batchStart != pluginNames_.end() && !cancelled_;) {
+      auto batchSize = std::min(
+          PLUGINS_PER_BATCH,
+          static_cast<size_t>(std::distance(batchStart, pluginNames_.end())));
+      auto batchEnd = batchStart + batchSize;
+
+      // Loading plugins discards the game handle's previously loaded plugins,
+      // but the objects stay alive as long as they're referenced.
+      gameHandle->LoadPlugins(std::vector<std::string>(batchStart, batchEnd),
+                              false);
+      auto batchPlugins = gameHandle->GetLoadedPlugins();
+
+      {
+        std::lock_guard<std::mutex> guard(mutex_);
+        plugins_.insert(
+            plugins_.end(), batchPlugins.begin(), batchPlugins.end());
+        loadedPluginCount_ += batchSize;
+      }
+      progressed_.notify_all();
+
+      batchStart = batchEnd;
+    }
+  } catch (const std::exception& e) {
+    if (logger) {
+      logger->error("Failed to fully load plugins in the background: {}",
+                    e.what());
+    }
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    failed_ = true;
+  }
+
+  if (logger) {
+    if (cancelled_) {
+      logger->debug("Cancelled fully loading plugins in the background.");
+    } else {
+      logger->debug("Finished fully loading plugins in the background.");
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    finished_ = true;
+  }
+  progressed_.notify_all();
+}
+}
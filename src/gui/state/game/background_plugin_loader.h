@@ -0,0 +1,95 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_BACKGROUND_PLUGIN_LOADER
+#define LOOT_GUI_STATE_GAME_BACKGROUND_PLUGIN_LOADER
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gui/state/cancellation_token.h"
+#include "loot/api.h"
+
+namespace loot {
+// Fully loads plugins on a background thread. Loading uses a separate game
+// handle so that it doesn't disturb the plugins that the game's own handle
+// has loaded, and is done in batches so that it can be cancelled and its
+// progress reported. Destroying the loader cancels it.
+class BackgroundPluginLoader {
+public:
+  // Called with the number of plugins that have been loaded, and the total
+  // number of plugins to load.
+  typedef std::function<void(size_t, size_t)> ProgressCallback;
+
+  BackgroundPluginLoader(GameType gameType,
+                         const std::filesystem::path& gamePath,
+                         const std::filesystem::path& gameLocalPath,
+                         const std::string& masterFile,
+                         const std::vector<std::string>& pluginNames);
+  ~BackgroundPluginLoader();
+
+  BackgroundPluginLoader(const BackgroundPluginLoader&) = delete;
+  BackgroundPluginLoader& operator=(const BackgroundPluginLoader&) = delete;
+
+  void Cancel();
+
+  bool IsFinished() const;
+
+  // Blocks until loading finishes, calling onProgress while waiting.
+  // Returns the loaded plugins, or nullopt if loading failed or was
+  // cancelled. Cancelling the wait throws but doesn't cancel the load.
+  std::optional<std::vector<std::shared_ptr<const PluginInterface>>> Wait(
+      const ProgressCallback& onProgress,
+      const CancellationToken& cancellationToken);
+
+private:
+  void Load(GameType gameType,
+            std::filesystem::path gamePath,
+            std::filesystem::path gameLocalPath,
+            std::string masterFile);
+
+  const std::vector<std::string> pluginNames_;
+  std::vector<std::shared_ptr<const PluginInterface>> plugins_;
+  size_t loadedPluginCount_;
+  bool finished_;
+  bool failed_;
+  std::atomic<bool> cancelled_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable progressed_;
+  std::thread thread_;
+};
+}
+
+#endif
@@ -0,0 +1,111 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_CONDITION_CACHE
+#define LOOT_GUI_STATE_GAME_CONDITION_CACHE
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace loot {
+// Memoizes the results of the file("...") and active("...") conditions that
+// install validity checks evaluate, so that a condition shared by many
+// plugins (e.g. on the game's main master file) is only evaluated once.
+// Results are keyed on the condition's function and argument text, so looking
+// up a condition doesn't involve building a string or normalising its
+// argument. Arguments are compared case-sensitively, so differently-cased
+// conditions on the same file are evaluated separately.
+//
+// The cache doesn't know what its conditions depend on, so like
+// DataDirectoryIndex it's a snapshot that is shared by all the plugins in one
+// pass over the load order, and a new one should be created whenever the load
+// order or installed files may have changed. Evaluation is thread-safe, and
+// evaluators should be cheap (e.g. data directory index lookups), as they are
+// run while holding the cache's lock.
+class ConditionCache {
+public:
+  enum class Function {
+    file,
+    active,
+  };
+
+  ConditionCache() : hitCount_(0), missCount_(0) {}
+
+  // Returns the cached result for the condition, or calls evaluate and caches
+  // its result if there isn't one.
+  template<typename Evaluator>
+  bool Evaluate(Function function,
+                const std::string& argument,
+                Evaluator evaluate) {
+    auto& results = GetResults(function);
+    {
+      std::shared_lock<std::shared_mutex> lock(mutex_);
+      auto it = results.find(argument);
+      if (it != results.end()) {
+        ++hitCount_;
+        return it->second;
+      }
+    }
+
+    // Another thread may have evaluated the condition since the lookup above.
+    // Evaluation is quick compared to contending for the lock, so do it while
+    // holding the lock to ensure that each condition is evaluated only once.
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = results.find(argument);
+    if (it != results.end()) {
+      ++hitCount_;
+      return it->second;
+    }
+
+    ++missCount_;
+    auto result = evaluate();
+    results.emplace(argument, result);
+
+    return result;
+  }
+
+  // The number of evaluations that were answered from the cache.
+  size_t GetHitCount() const { return hitCount_; }
+
+  // The number of evaluations that had to call their evaluate function.
+  size_t GetMissCount() const { return missCount_; }
+
+private:
+  std::unordered_map<std::string, bool>& GetResults(Function function) {
+    return function == Function::file ? fileResults_ : activeResults_;
+  }
+
+  std::unordered_map<std::string, bool> fileResults_;
+  std::unordered_map<std::string, bool> activeResults_;
+  mutable std::shared_mutex mutex_;
+  std::atomic<size_t> hitCount_;
+  std::atomic<size_t> missCount_;
+};
+}
+
+#endif
@@ -0,0 +1,152 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/game/data_directory_index.h"
+
+#include <functional>
+#include <set>
+
+#include <boost/functional/hash.hpp>
+
+#include "gui/helpers.h"
+#include "gui/state/logging.h"
+
+namespace loot {
+namespace {
+bool isFilename(const std::string& relativePath) {
+  return relativePath.find_first_of("/\\") == std::string::npos &&
+         relativePath != "." && relativePath != "..";
+}
+}
+
+DataDirectoryIndex::DataDirectoryIndex(
+    const std::filesystem::path& dataPath) :
+    dataPath_(dataPath),
+    fingerprint_(0),
+    indexedLookupCount_(0),
+    filesystemLookupCount_(0) {
+  std::error_code errorCode;
+  if (!std::filesystem::is_directory(dataPath_, errorCode)) {
+    return;
+  }
+
+  // Don't throw if the directory can't be read, as lookups will then just
+  // report that the file is missing, as they would if using the filesystem.
+  for (std::filesystem::directory_iterator it(dataPath_, errorCode), end;
+       !errorCode && it != end;
+       it.increment(errorCode)) {
+    auto entry = NormalizeFilename(it->path().filename().u8string());
+
+    // Summing the hashes makes the fingerprint independent of the order that
+    // entries are read in.
+    fingerprint_ += std::hash<std::string>()(entry);
+    entries_.insert(entry);
+  }
+
+  if (errorCode) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->error("Failed to read the contents of \"{}\". Details: {}",
+                    dataPath_.u8string(),
+                    errorCode.message());
+    }
+  }
+}
+
+bool DataDirectoryIndex::CanIndex(const std::string& relativePath) {
+  return isFilename(relativePath);
+}
+
+bool DataDirectoryIndex::Exists(const std::string& relativePath) const {
+  if (!CanIndex(relativePath)) {
+    ++filesystemLookupCount_;
+    return std::filesystem::exists(dataPath_ /
+                                   std::filesystem::u8path(relativePath));
+  }
+
+  ++indexedLookupCount_;
+  return entries_.count(NormalizeFilename(relativePath)) > 0;
+}
+
+size_t DataDirectoryIndex::GetEntryCount() const { return entries_.size(); }
+
+size_t DataDirectoryIndex::GetFingerprint() const { return fingerprint_; }
+
+size_t DataDirectoryIndex::GetFileStateFingerprint(
+    const std::unordered_set<std::string>& relativePaths) const {
+  // A directory's modification time changes when entries are added to or
+  // removed from it, which covers paths that are regexes.
+  std::set<std::string> paths;
+  for (const auto& relativePath : relativePaths) {
+    paths.insert(relativePath);
+
+    // Metadata paths may use either separator, but a backslash after the
+    // last forward slash may be an escape in a regex filename.
+    auto separatorPos = relativePath.rfind('/');
+    if (separatorPos == std::string::npos) {
+      separatorPos = relativePath.rfind('\\');
+    }
+    paths.insert(separatorPos == std::string::npos
+                     ? ""
+                     : relativePath.substr(0, separatorPos));
+  }
+
+  filesystemLookupCount_ += paths.size();
+
+  size_t fingerprint = 0;
+  for (const auto& relativePath : paths) {
+    auto path = dataPath_ / std::filesystem::u8path(relativePath);
+    size_t pathState = std::hash<std::string>()(relativePath);
+
+    std::error_code errorCode;
+    auto status = std::filesystem::status(path, errorCode);
+    if (std::filesystem::exists(status)) {
+      boost::hash_combine(
+          pathState,
+          std::filesystem::last_write_time(path, errorCode)
+              .time_since_epoch()
+              .count());
+    }
+    if (std::filesystem::is_regular_file(status)) {
+      boost::hash_combine(pathState,
+                          std::filesystem::file_size(path, errorCode));
+    }
+
+    // Summing the hashes makes the fingerprint independent of the paths'
+    // order.
+    fingerprint += pathState;
+  }
+
+  return fingerprint;
+}
+
+size_t DataDirectoryIndex::GetIndexedLookupCount() const {
+  return indexedLookupCount_;
+}
+
+size_t DataDirectoryIndex::GetFilesystemLookupCount() const {
+  return filesystemLookupCount_;
+}
+}
@@ -0,0 +1,84 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_DATA_DIRECTORY_INDEX
+#define LOOT_GUI_STATE_GAME_DATA_DIRECTORY_INDEX
+
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <unordered_set>
+
+namespace loot {
+// Holds the names of the entries in a game's data directory, so that checking
+// whether a file is installed doesn't need a filesystem call. Names are
+// compared case-insensitively. Paths that aren't just a filename (e.g. they
+// include a subdirectory) can't be answered from the index, so fall back to
+// checking the filesystem.
+//
+// The index is a snapshot, so a new one should be created whenever the
+// directory's current state is needed. Lookups are thread-safe.
+class DataDirectoryIndex {
+public:
+  explicit DataDirectoryIndex(const std::filesystem::path& dataPath);
+
+  // Checks if the existence of the given path can be answered from an index,
+  // rather than needing a filesystem call.
+  static bool CanIndex(const std::string& relativePath);
+
+  // Equivalent to std::filesystem::exists(dataPath / u8path(relativePath)).
+  bool Exists(const std::string& relativePath) const;
+
+  size_t GetEntryCount() const;
+
+  // Summarises the index's entries, so that indices with the same entries
+  // have the same fingerprint, no matter what order they were read in.
+  size_t GetFingerprint() const;
+
+  // Summarises the existence, size and modification time of the given paths
+  // and their parent directories, which the entry fingerprint doesn't cover.
+  // Paths' filenames may be regexes, as in metadata conditions, in which case
+  // only their parent directories' states can be used. Each path checked is
+  // counted as a filesystem lookup.
+  size_t GetFileStateFingerprint(
+      const std::unordered_set<std::string>& relativePaths) const;
+
+  // The number of lookups that were answered from the index, each of which
+  // would otherwise have been a filesystem call.
+  size_t GetIndexedLookupCount() const;
+
+  // The number of lookups that had to check the filesystem.
+  size_t GetFilesystemLookupCount() const;
+
+private:
+  std::filesystem::path dataPath_;
+  std::unordered_set<std::string> entries_;
+  size_t fingerprint_;
+  mutable std::atomic<size_t> indexedLookupCount_;
+  mutable std::atomic<size_t> filesystemLookupCount_;
+};
+}
+
+#endif
@@ -0,0 +1,209 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_DERIVED_METADATA_CACHE
+#define LOOT_GUI_STATE_GAME_DERIVED_METADATA_CACHE
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "gui/helpers.h"
+#include "loot/api.h"
+
+namespace loot {
+// Remembers each plugin's serialised derived metadata, so that responses that
+// include every plugin don't need to derive metadata for plugins that haven't
+// changed since the last response.
+//
+// An entry is only reused for a plugin with the same name, CRC and load order
+// index (which also records whether it is active). Headers-only loads don't
+// calculate CRCs, so if either plugin has no CRC the entry is only reused for
+// the same loaded plugin object, which the plugin cache keeps while the
+// plugin's file is unchanged.
+// Everything else that can change all plugins' derived metadata at once is
+// summarised as a context value, and changing the context clears the cache.
+// Changes to metadata are not detected, so entries must be invalidated when
+// metadata changes. Each invalidation starts a new metadata generation, and
+// entries derived during an earlier generation are not added, so that
+// metadata derived while the metadata was being changed isn't cached.
+// Lookups are thread-safe.
+class DerivedMetadataCache {
+public:
+  struct Entry {
+    std::string json;
+    uint64_t metadataHash;
+  };
+
+  DerivedMetadataCache() :
+      context_(0), generation_(0), hitCount_(0), missCount_(0) {}
+
+  DerivedMetadataCache(const DerivedMetadataCache& other) :
+      hitCount_(0), missCount_(0) {
+    std::lock_guard<std::mutex> guard(other.mutex_);
+    context_ = other.context_;
+    generation_ = other.generation_;
+    entries_ = other.entries_;
+  }
+
+  DerivedMetadataCache& operator=(const DerivedMetadataCache& other) {
+    if (&other != this) {
+      std::scoped_lock lock(mutex_, other.mutex_);
+      context_ = other.context_;
+      // Don't let metadata that's being derived for this cache be added.
+      generation_ = std::max(generation_, other.generation_) + 1;
+      entries_ = other.entries_;
+    }
+
+    return *this;
+  }
+
+  // Clears the cache if the given context is different from the current one.
+  void SetContext(size_t context) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (context != context_) {
+      context_ = context;
+      ClearEntries();
+    }
+  }
+
+  // The current metadata generation, which should be read before deriving
+  // metadata to add to the cache.
+  uint64_t GetGeneration() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return generation_;
+  }
+
+  std::optional<Entry> Get(const std::shared_ptr<const PluginInterface>& plugin,
+                           std::optional<short> loadOrderIndex) const {
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    auto it = entries_.find(NormalizeFilename(plugin->GetName()));
+    if (it == entries_.end() || !it->second.IsFor(*plugin) ||
+        it->second.loadOrderIndex != loadOrderIndex) {
+      ++missCount_;
+      return std::nullopt;
+    }
+
+    ++hitCount_;
+    return it->second.entry;
+  }
+
+  // The entry is not added if the metadata has changed since the given
+  // generation.
+  void Set(const std::shared_ptr<const PluginInterface>& plugin,
+           std::optional<short> loadOrderIndex,
+           const Entry& entry,
+           uint64_t generation) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (generation != generation_) {
+      return;
+    }
+
+    entries_.insert_or_assign(
+        NormalizeFilename(plugin->GetName()),
+        CachedEntry{plugin->GetName(),
+                    plugin->GetCRC(),
+                    plugin,
+                    loadOrderIndex,
+                    entry});
+  }
+
+  void Invalidate(const std::string& pluginName) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    ++generation_;
+    entries_.erase(NormalizeFilename(pluginName));
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    ClearEntries();
+  }
+
+  size_t Size() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return entries_.size();
+  }
+
+  // An estimate of the memory used by the cached entries, which is dominated
+  // by their serialised metadata.
+  size_t GetMemoryUsage() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    size_t usage = 0;
+    for (const auto& [key, cachedEntry] : entries_) {
+      usage += sizeof(cachedEntry) + key.size() + cachedEntry.name.size() +
+               cachedEntry.entry.json.size();
+    }
+    return usage;
+  }
+
+  size_t GetHitCount() const { return hitCount_; }
+
+  size_t GetMissCount() const { return missCount_; }
+
+private:
+  struct CachedEntry {
+    std::string name;
+    std::optional<uint32_t> crc;
+    // Holding the plugin object means that it can't be destroyed and another
+    // plugin object created at the same address while the entry exists.
+    std::shared_ptr<const PluginInterface> plugin;
+    std::optional<short> loadOrderIndex;
+    Entry entry;
+
+    bool IsFor(const PluginInterface& otherPlugin) const {
+      if (otherPlugin.GetName() != name) {
+        return false;
+      }
+
+      auto otherCrc = otherPlugin.GetCRC();
+      if (crc.has_value() && otherCrc.has_value()) {
+        return crc == otherCrc;
+      }
+
+      return plugin.get() == &otherPlugin;
+    }
+  };
+
+  void ClearEntries() {
+    ++generation_;
+    entries_.clear();
+  }
+
+  mutable std::mutex mutex_;
+  size_t context_;
+  uint64_t generation_;
+  std::unordered_map<std::string, CachedEntry> entries_;
+  mutable std::atomic<size_t> hitCount_;
+  mutable std::atomic<size_t> missCount_;
+};
+}
+
+#endif
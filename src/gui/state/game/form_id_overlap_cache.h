@@ -0,0 +1,146 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_FORM_ID_OVERLAP_CACHE
+#define LOOT_GUI_STATE_GAME_FORM_ID_OVERLAP_CACHE
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "gui/helpers.h"
+#include "loot/api.h"
+
+namespace loot {
+// Remembers which plugins have FormIDs that overlap with those of recently
+// checked plugins, so that checking the same plugin again doesn't need to
+// compare it against every other plugin again while the loaded plugins stay
+// the same. Only the most recently checked plugins' results are kept, to
+// bound memory usage. Lookups are thread-safe.
+class FormIdOverlapCache {
+public:
+  // The normalised filenames of overlapping plugins.
+  typedef std::unordered_set<std::string> OverlappingPlugins;
+
+  static constexpr size_t DEFAULT_CAPACITY = 16;
+
+  explicit FormIdOverlapCache(size_t capacity = DEFAULT_CAPACITY) :
+      capacity_(capacity) {}
+
+  FormIdOverlapCache(const FormIdOverlapCache& other) {
+    std::lock_guard<std::mutex> guard(other.mutex_);
+    capacity_ = other.capacity_;
+    entries_ = other.entries_;
+  }
+
+  FormIdOverlapCache& operator=(const FormIdOverlapCache& other) {
+    if (&other != this) {
+      std::scoped_lock lock(mutex_, other.mutex_);
+      capacity_ = other.capacity_;
+      entries_ = other.entries_;
+    }
+
+    return *this;
+  }
+
+  // Get which of the given plugins overlap with the given plugin, which must
+  // be the same set of plugins each time until the cache is cleared.
+  std::shared_ptr<const OverlappingPlugins> GetOverlappingPlugins(
+      const PluginInterface& plugin,
+      const std::vector<std::shared_ptr<const PluginInterface>>& plugins) {
+    auto key = NormalizeFilename(plugin.GetName());
+
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      auto overlappingPlugins = Find(key);
+      if (overlappingPlugins) {
+        return overlappingPlugins;
+      }
+    }
+
+    auto overlappingPlugins = std::make_shared<const OverlappingPlugins>(
+        FindOverlappingPlugins(plugin, plugins));
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!Find(key)) {
+      entries_.emplace_front(key, overlappingPlugins);
+      while (entries_.size() > capacity_) {
+        entries_.pop_back();
+      }
+    }
+
+    return overlappingPlugins;
+  }
+
+  static OverlappingPlugins FindOverlappingPlugins(
+      const PluginInterface& plugin,
+      const std::vector<std::shared_ptr<const PluginInterface>>& plugins) {
+    OverlappingPlugins overlappingPlugins;
+    for (const auto& otherPlugin : plugins) {
+      if (plugin.DoFormIDsOverlap(*otherPlugin)) {
+        overlappingPlugins.insert(NormalizeFilename(otherPlugin->GetName()));
+      }
+    }
+
+    return overlappingPlugins;
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    entries_.clear();
+  }
+
+  size_t Size() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return entries_.size();
+  }
+
+private:
+  typedef std::pair<std::string, std::shared_ptr<const OverlappingPlugins>>
+      Entry;
+
+  // Moves a found entry to the front, so that the least recently used entry
+  // is always at the back. The mutex must be held when calling this.
+  std::shared_ptr<const OverlappingPlugins> Find(const std::string& key) {
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+      if (it->first == key) {
+        entries_.splice(entries_.begin(), entries_, it);
+        return it->second;
+      }
+    }
+
+    return nullptr;
+  }
+
+  mutable std::mutex mutex_;
+  size_t capacity_;
+  std::list<Entry> entries_;
+};
+}
+
+#endif
@@ -86,8 +86,18 @@ Game::Game(const Game& game) :
     lootDataPath_(game.lootDataPath_),
     gameHandle_(game.gameHandle_),
     pluginsFullyLoaded_(game.pluginsFullyLoaded_),
+    loadedPlugins_(game.loadedPlugins_),
+    pluginCache_(game.pluginCache_),
+    externallyLoadedPlugins_(game.externallyLoadedPlugins_),
+    backgroundLoader_(game.backgroundLoader_),
+    formIdOverlapCache_(game.formIdOverlapCache_),
+    derivedMetadataCache_(game.derivedMetadataCache_),
+    loadedListsState_(game.loadedListsState_),
     messages_(game.messages_),
-    loadOrderSortCount_(0) {}
+    loadOrderSortCount_(0) {
+  lock_guard<mutex> guard(game.metadataPathsMutex_);
+  metadataPaths_ = game.metadataPaths_;
+}
 
 Game& Game::operator=(const Game& game) {
   if (&game != this) {
@@ -96,6 +106,17 @@ Game& Game::operator=(const Game& game) {
     lootDataPath_ = game.lootDataPath_;
     gameHandle_ = game.gameHandle_;
     pluginsFullyLoaded_ = game.pluginsFullyLoaded_;
+    loadedPlugins_ = game.loadedPlugins_;
+    pluginCache_ = game.pluginCache_;
+    externallyLoadedPlugins_ = game.externallyLoadedPlugins_;
+    backgroundLoader_ = game.backgroundLoader_;
+    formIdOverlapCache_ = game.formIdOverlapCache_;
+    derivedMetadataCache_ = game.derivedMetadataCache_;
+    {
+      std::scoped_lock guard(metadataPathsMutex_, game.metadataPathsMutex_);
+      metadataPaths_ = game.metadataPaths_;
+    }
+    loadedListsState_ = game.loadedListsState_;
     messages_ = game.messages_;
     loadOrderSortCount_ = game.loadOrderSortCount_;
   }
@@ -113,6 +134,14 @@ void Game::Init() {
   messages_.clear();
   loadOrderSortCount_ = 0;
   pluginsFullyLoaded_ = false;
+  loadedPlugins_.clear();
+  externallyLoadedPlugins_.clear();
+  backgroundLoader_.reset();
+  pluginCache_ = PluginCache();
+  formIdOverlapCache_.Clear();
+  derivedMetadataCache_.Clear();
+  ClearMetadataPaths();
+  loadedListsState_.reset();
 
   gameHandle_ = CreateGameHandle(Type(), GamePath(), GameLocalPath());
   gameHandle_->IdentifyMainMasterFile(Master());
@@ -128,21 +157,97 @@ void Game::Init() {
       }
       fs::create_directories(lootGamePath);
     }
+
+    pluginCache_ = PluginCache(lootGamePath / "plugin_cache.json");
+    pluginCache_.Load();
   }
 }
 
 std::shared_ptr<const PluginInterface> Game::GetPlugin(
     const std::string& name) const {
+  if (!externallyLoadedPlugins_.empty()) {
+    auto it = externallyLoadedPlugins_.find(NormalizeFilename(name));
+    if (it != externallyLoadedPlugins_.end()) {
+      return it->second;
+    }
+  }
+
   return gameHandle_->GetPlugin(name);
 }
 
 std::vector<std::shared_ptr<const PluginInterface>> Game::GetPlugins() const {
-  return gameHandle_->GetLoadedPlugins();
+  auto plugins = gameHandle_->GetLoadedPlugins();
+  if (externallyLoadedPlugins_.empty()) {
+    return plugins;
+  }
+
+  // Don't return any plugins that the game handle loaded before the externally
+  // loaded plugins replaced them.
+  plugins.erase(
+      std::remove_if(plugins.begin(),
+                     plugins.end(),
+                     [&](const std::shared_ptr<const PluginInterface>& plugin) {
+                       return externallyLoadedPlugins_.count(
+                                  NormalizeFilename(plugin->GetName())) > 0;
+                     }),
+      plugins.end());
+
+  for (const auto& externallyLoadedPlugin : externallyLoadedPlugins_) {
+    plugins.push_back(externallyLoadedPlugin.second);
+  }
+
+  return plugins;
 }
 
 std::vector<Message> Game::CheckInstallValidity(
     const std::shared_ptr<const PluginInterface>& plugin,
     const PluginMetadata& metadata) {
+  return CheckInstallValidity(
+      plugin,
+      metadata,
+      [&](const std::string& file) {
+        return std::filesystem::exists(DataPath() / u8path(file)) ||
+               (hasPluginFileExtension(file) &&
+                std::filesystem::exists(DataPath() / u8path(file + ".ghost")));
+      },
+      [&](const std::string& pluginName) {
+        return IsPluginActive(pluginName);
+      });
+}
+
+std::vector<Message> Game::CheckInstallValidity(
+    const std::shared_ptr<const PluginInterface>& plugin,
+    const PluginMetadata& metadata,
+    const DataDirectoryIndex& dataDirectoryIndex,
+    ConditionCache& conditionCache) {
+  return CheckInstallValidity(
+      plugin,
+      metadata,
+      [&](const std::string& file) {
+        return conditionCache.Evaluate(
+            ConditionCache::Function::file, file, [&]() {
+              return dataDirectoryIndex.Exists(file) ||
+                     (hasPluginFileExtension(file) &&
+                      dataDirectoryIndex.Exists(file + ".ghost"));
+            });
+      },
+      [&](const std::string& pluginName) {
+        return conditionCache.Evaluate(
+            ConditionCache::Function::active, pluginName, [&]() {
+              return IsPluginActive(pluginName);
+            });
+      });
+}
+
+std::shared_ptr<const DataDirectoryIndex> Game::IndexDataDirectory() const {
+  return std::make_shared<DataDirectoryIndex>(DataPath());
+}
+
+std::vector<Message> Game::CheckInstallValidity(
+    const std::shared_ptr<const PluginInterface>& plugin,
+    const PluginMetadata& metadata,
+    const std::function<bool(const std::string&)>& fileExists,
+    const std::function<bool(const std::string&)>& isActive) {
   auto logger = getLogger();
 
   if (logger) {
@@ -151,13 +256,7 @@ std::vector<Message> Game::CheckInstallValidity(
         plugin->GetName());
   }
   std::vector<Message> messages;
-  if (IsPluginActive(plugin->GetName())) {
-    auto fileExists = [&](const std::string& file) {
-      return std::filesystem::exists(DataPath() / u8path(file)) ||
-             (hasPluginFileExtension(file) &&
-              std::filesystem::exists(DataPath() / u8path(file + ".ghost")));
-    };
-
+  if (isActive(plugin->GetName())) {
     auto tags = metadata.GetTags();
     auto hasFilterTag =
         std::any_of(tags.cbegin(), tags.cend(), [&](const Tag& tag) {
@@ -179,7 +278,7 @@ std::vector<Message> Game::CheckInstallValidity(
                                     "installed, but it is missing.")) %
                                 master)
                                    .str()));
-        } else if (!IsPluginActive(master)) {
+        } else if (!isActive(master)) {
           if (logger) {
             logger->error("\"{}\" requires \"{}\", but it is inactive.",
                           plugin->GetName(),
@@ -224,7 +323,7 @@ std::vector<Message> Game::CheckInstallValidity(
     for (const auto& inc : metadata.GetIncompatibilities()) {
       auto file = std::string(inc.GetName());
       if (fileExists(file) &&
-          (!hasPluginFileExtension(file) || IsPluginActive(file))) {
+          (!hasPluginFileExtension(file) || isActive(file))) {
         if (logger) {
           logger->error(
               "\"{}\" is incompatible with \"{}\", but both are present.",
@@ -389,7 +488,9 @@ void Game::RedatePlugins() {
   }
 }
 
-void Game::LoadAllInstalledPlugins(bool headersOnly) {
+void Game::LoadAllInstalledPlugins(
+    bool headersOnly,
+    const CancellationToken& cancellationToken) {
   try {
     gameHandle_->LoadCurrentLoadOrderState();
   } catch (std::exception& e) {
@@ -404,12 +505,74 @@ void Game::LoadAllInstalledPlugins(bool headersOnly) {
             .str()));
   }
 
-  auto installedPluginNames = GetInstalledPluginNames();
-  gameHandle_->LoadPlugins(installedPluginNames, headersOnly);
+  auto installedPlugins = GetInstalledPlugins();
+  cancellationToken.ThrowIfCancelled();
+
+  // Loading plugins discards any previously loaded plugins, so it's only
+  // possible to skip reloading if none of them have changed.
+  if (installedPlugins == loadedPlugins_ &&
+      (headersOnly || pluginsFullyLoaded_)) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->debug(
+          "No plugins have been added, removed or changed since they were "
+          "last loaded, skipping reloading them.");
+    }
+    return;
+  }
+
+  // The cache holds headers and CRCs but not FormIDs, so fully loading
+  // plugins needs libloot to read them all.
+  std::unordered_map<std::string, std::shared_ptr<const PluginInterface>>
+      cachedPlugins;
+  std::vector<std::string> installedPluginNames;
+  std::vector<std::string> pluginNamesToLoad;
+  for (const auto& installedPlugin : installedPlugins) {
+    cancellationToken.ThrowIfCancelled();
+
+    installedPluginNames.push_back(installedPlugin.name);
+
+    auto cachedPlugin =
+        headersOnly ? pluginCache_.Find(installedPlugin) : nullptr;
+    if (cachedPlugin) {
+      cachedPlugins.emplace(NormalizeFilename(installedPlugin.name),
+                            cachedPlugin);
+    } else {
+      pluginNamesToLoad.push_back(installedPlugin.name);
+    }
+  }
+
+  auto logger = getLogger();
+  if (logger && headersOnly && !installedPlugins.empty()) {
+    logger->debug(
+        "Found {} of {} installed plugins in the plugin cache, a hit rate of "
+        "{:.1f}%.",
+        cachedPlugins.size(),
+        installedPlugins.size(),
+        100.0 * cachedPlugins.size() / installedPlugins.size());
+  }
+
+  // This is the last chance to cancel, as loading replaces the loaded plugins
+  // and the game's state must be kept consistent with them.
+  cancellationToken.ThrowIfCancelled();
+
+  formIdOverlapCache_.Clear();
+  ClearMetadataPaths();
+
+  // Any background load is of plugins that are about to be replaced.
+  backgroundLoader_.reset();
+
+  externallyLoadedPlugins_ = std::move(cachedPlugins);
+
+  // This is done even if there are no plugins to load, so that libloot
+  // discards any plugins it previously loaded.
+  gameHandle_->LoadPlugins(pluginNamesToLoad, headersOnly);
+
+  UpdatePluginCache(installedPlugins);
 
   // Check if any plugins have been removed.
   std::vector<std::string> loadedPluginNames;
-  for (auto plugin : gameHandle_->GetLoadedPlugins()) {
+  for (auto plugin : GetPlugins()) {
     loadedPluginNames.push_back(plugin->GetName());
   }
 
@@ -417,10 +580,83 @@ void Game::LoadAllInstalledPlugins(bool headersOnly) {
       CheckForRemovedPlugins(installedPluginNames, loadedPluginNames));
 
   pluginsFullyLoaded_ = !headersOnly;
+  loadedPlugins_ = installedPlugins;
 }
 
 bool Game::ArePluginsFullyLoaded() const { return pluginsFullyLoaded_; }
 
+void Game::StartBackgroundFullLoad() {
+  if (pluginsFullyLoaded_ || loadedPlugins_.empty()) {
+    return;
+  }
+
+  std::vector<std::string> pluginNames;
+  for (const auto& loadedPlugin : loadedPlugins_) {
+    pluginNames.push_back(loadedPlugin.name);
+  }
+
+  // Replacing the loader cancels any load that is already in progress.
+  backgroundLoader_.reset();
+  backgroundLoader_ = std::make_shared<BackgroundPluginLoader>(
+      Type(), GamePath(), GameLocalPath(), Master(), pluginNames);
+}
+
+void Game::CancelBackgroundFullLoad() {
+  // Copies of the game share the loader, so resetting this game's pointer
+  // isn't enough to stop it.
+  if (backgroundLoader_) {
+    backgroundLoader_->Cancel();
+    backgroundLoader_.reset();
+  }
+}
+
+void Game::WaitForFullyLoadedPlugins(
+    const BackgroundPluginLoader::ProgressCallback& onProgress,
+    const CancellationToken& cancellationToken) {
+  if (pluginsFullyLoaded_) {
+    return;
+  }
+
+  // If waiting is cancelled, the background load is kept so that it can be
+  // waited for again later.
+  std::optional<std::vector<std::shared_ptr<const PluginInterface>>> plugins;
+  if (backgroundLoader_) {
+    plugins = backgroundLoader_->Wait(onProgress, cancellationToken);
+    backgroundLoader_.reset();
+  }
+
+  // The background load is only usable if the installed plugins haven't
+  // changed since it started.
+  auto installedPlugins = GetInstalledPlugins();
+  if (!plugins.has_value() || installedPlugins != loadedPlugins_) {
+    LoadAllInstalledPlugins(false, cancellationToken);
+    return;
+  }
+
+  externallyLoadedPlugins_.clear();
+  for (const auto& plugin : plugins.value()) {
+    externallyLoadedPlugins_.emplace(NormalizeFilename(plugin->GetName()),
+                                     plugin);
+  }
+
+  formIdOverlapCache_.Clear();
+  pluginsFullyLoaded_ = true;
+
+  UpdatePluginCache(installedPlugins);
+}
+
+std::shared_ptr<const FormIdOverlapCache::OverlappingPlugins>
+Game::GetOverlappingPlugins(const PluginInterface& plugin) const {
+  // Plugins that have only had their headers loaded have no FormIDs, so
+  // don't remember results that would be wrong once they are fully loaded.
+  if (!pluginsFullyLoaded_) {
+    return std::make_shared<const FormIdOverlapCache::OverlappingPlugins>(
+        FormIdOverlapCache::FindOverlappingPlugins(plugin, GetPlugins()));
+  }
+
+  return formIdOverlapCache_.GetOverlappingPlugins(plugin, GetPlugins());
+}
+
 fs::path Game::MasterlistPath() const {
   return lootDataPath_ / u8path(FolderName()) / "masterlist.yaml";
 }
@@ -440,6 +676,10 @@ std::vector<std::string> Game::GetLoadOrder() const {
 void Game::SetLoadOrder(const std::vector<std::string>& loadOrder) {
   BackupLoadOrder(GetLoadOrder(), lootDataPath_ / u8path(FolderName()));
   gameHandle_->SetLoadOrder(loadOrder);
+
+  // Changing which plugins are active can change the install validity of
+  // other plugins.
+  derivedMetadataCache_.Clear();
 }
 
 bool Game::IsPluginActive(const std::string& pluginName) const {
@@ -473,6 +713,19 @@ std::optional<short> Game::GetActiveLoadOrderIndex(
   return std::nullopt;
 }
 
+LoadOrderIndexTable Game::GetActiveLoadOrderIndices(
+    const std::vector<std::string>& loadOrder) const {
+  LoadOrderIndexTable indices;
+  for (const std::string& pluginName : loadOrder) {
+    auto plugin = GetPlugin(pluginName);
+    if (plugin && IsPluginActive(pluginName)) {
+      indices.AddActivePlugin(plugin->GetName(), plugin->IsLightPlugin());
+    }
+  }
+
+  return indices;
+}
+
 std::vector<std::string> Game::SortPlugins() {
   auto logger = getLogger();
 
@@ -499,6 +752,11 @@ std::vector<std::string> Game::SortPlugins() {
 
     sortedPlugins = gameHandle_->SortPlugins(currentLoadOrder);
 
+    // Sorting fully loads all plugins, replacing any that were loaded from the
+    // plugin cache, so cache their CRCs too.
+    externallyLoadedPlugins_.clear();
+    UpdatePluginCache(loadedPlugins_);
+
     AppendMessages(CheckForRemovedPlugins(currentLoadOrder, sortedPlugins));
 
     IncrementLoadOrderSortCount();
@@ -551,9 +809,16 @@ void Game::DecrementLoadOrderSortCount() {
 std::vector<Message> Game::GetMessages() const {
   std::vector<Message> output(
       gameHandle_->GetDatabase()->GetGeneralMessages(true));
-  output.insert(end(output), begin(messages_), end(messages_));
 
-  if (loadOrderSortCount_ == 0)
+  bool hasSortedLoadOrder = false;
+  {
+    lock_guard<mutex> guard(mutex_);
+
+    output.insert(end(output), begin(messages_), end(messages_));
+    hasSortedLoadOrder = loadOrderSortCount_ > 0;
+  }
+
+  if (!hasSortedLoadOrder)
     output.push_back(PlainTextMessage(
         MessageType::warn,
         boost::locale::translate(
@@ -614,6 +879,16 @@ bool Game::UpdateMasterlist() {
             "usually minor and fixed within hours.")));
   }
 
+  if (wasUpdated) {
+    derivedMetadataCache_.Clear();
+    ClearMetadataPaths();
+
+    // The updated masterlist has been loaded in place of the old one.
+    if (loadedListsState_.has_value()) {
+      loadedListsState_->masterlist = GetMetadataListsState().masterlist;
+    }
+  }
+
   return wasUpdated;
 }
 
@@ -644,6 +919,11 @@ void Game::LoadMetadata() {
   if (logger) {
     logger->debug("Parsing metadata list(s).");
   }
+  derivedMetadataCache_.Clear();
+  ClearMetadataPaths();
+  // Record the lists' state before parsing them, so that any change made
+  // while they're being parsed is picked up next time.
+  loadedListsState_ = GetMetadataListsState();
   try {
     gameHandle_->GetDatabase()->LoadLists(masterlistPath, userlistPath);
   } catch (std::exception& e) {
@@ -671,6 +951,11 @@ void Game::LoadMetadata() {
   }
 }
 
+bool Game::HaveMetadataListsChanged() const {
+  return !loadedListsState_.has_value() ||
+         !(loadedListsState_.value() == GetMetadataListsState());
+}
+
 std::vector<std::string> Game::GetKnownBashTags() const {
   return gameHandle_->GetDatabase()->GetKnownBashTags();
 }
@@ -697,28 +982,105 @@ std::optional<PluginMetadata> Game::GetUserMetadata(
                                                            evaluateConditions);
 }
 
+DerivedMetadataCache& Game::GetDerivedMetadataCache() const {
+  return derivedMetadataCache_;
+}
+
+std::shared_ptr<const MetadataPaths> Game::GetMetadataPaths() const {
+  lock_guard<mutex> guard(metadataPathsMutex_);
+  if (metadataPaths_) {
+    return metadataPaths_;
+  }
+
+  auto plugins = GetPlugins();
+  std::vector<PluginMetadata> metadata;
+  for (const auto& plugin : plugins) {
+    for (const auto& pluginMetadata :
+         {GetMasterlistMetadata(plugin->GetName()),
+          GetUserMetadata(plugin->GetName())}) {
+      if (pluginMetadata.has_value()) {
+        metadata.push_back(pluginMetadata.value());
+      }
+    }
+  }
+
+  metadataPaths_ =
+      std::make_shared<MetadataPaths>(FindMetadataPaths(plugins, metadata));
+
+  return metadataPaths_;
+}
+
 void Game::SetUserGroups(const std::vector<Group>& groups) {
-  return gameHandle_->GetDatabase()->SetUserGroups(groups);
+  gameHandle_->GetDatabase()->SetUserGroups(groups);
+  // Plugins' group messages depend on which groups exist.
+  derivedMetadataCache_.Clear();
 }
 
 void Game::AddUserMetadata(const PluginMetadata& metadata) {
   gameHandle_->GetDatabase()->SetPluginUserMetadata(metadata);
+  derivedMetadataCache_.Invalidate(metadata.GetName());
+  ClearMetadataPaths();
 }
 
 void Game::ClearUserMetadata(const std::string& pluginName) {
   gameHandle_->GetDatabase()->DiscardPluginUserMetadata(pluginName);
+  derivedMetadataCache_.Invalidate(pluginName);
+  ClearMetadataPaths();
 }
 
 void Game::ClearAllUserMetadata() {
   gameHandle_->GetDatabase()->DiscardAllUserMetadata();
+  derivedMetadataCache_.Clear();
+  ClearMetadataPaths();
 }
 
 void Game::SaveUserMetadata() {
   gameHandle_->GetDatabase()->WriteUserMetadata(UserlistPath(), true);
+
+  // The written userlist matches the loaded user metadata.
+  if (loadedListsState_.has_value()) {
+    loadedListsState_->userlist = GetMetadataListsState().userlist;
+  }
 }
 
-std::vector<std::string> Game::GetInstalledPluginNames() {
-  std::vector<std::string> plugins;
+size_t Game::EstimateMemoryUsage() const {
+  // Parsed masterlists are typically a few tens of megabytes in memory.
+  static constexpr size_t METADATA_LISTS_SIZE = 32 * 1024 * 1024;
+  // Loaded plugin headers, with their masters, description and other data.
+  static constexpr size_t PLUGIN_HEADER_SIZE = 8 * 1024;
+  // Fully loaded plugins also hold their records' FormIDs, which take up
+  // much less space than the records themselves.
+  static constexpr size_t PLUGIN_FILE_SIZE_DIVISOR = 8;
+
+  size_t estimate = loadedListsState_.has_value() ? METADATA_LISTS_SIZE : 0;
+  for (const auto& plugin : loadedPlugins_) {
+    estimate += PLUGIN_HEADER_SIZE;
+    if (pluginsFullyLoaded_) {
+      estimate += plugin.size / PLUGIN_FILE_SIZE_DIVISOR;
+    }
+  }
+
+  estimate += derivedMetadataCache_.GetMemoryUsage();
+
+  return estimate;
+}
+
+Game::MetadataListsState Game::GetMetadataListsState() const {
+  auto getLastWriteTime = [](const std::filesystem::path& path)
+      -> std::optional<std::filesystem::file_time_type> {
+    std::error_code errorCode;
+    auto lastWriteTime = fs::last_write_time(path, errorCode);
+    if (errorCode) {
+      return std::nullopt;
+    }
+    return lastWriteTime;
+  };
+
+  return {getLastWriteTime(MasterlistPath()), getLastWriteTime(UserlistPath())};
+}
+
+std::vector<InstalledPlugin> Game::GetInstalledPlugins() {
+  std::vector<InstalledPlugin> plugins;
 
   auto logger = getLogger();
   if (logger) {
@@ -736,13 +1098,39 @@ std::vector<std::string> Game::GetInstalledPluginNames() {
         logger->info("Found plugin: {}", name);
       }
 
-      plugins.push_back(name);
+      plugins.push_back({name, it->file_size(), it->last_write_time()});
     }
   }
 
+  // Directory iteration order is unspecified, so sort the plugins to make
+  // comparing them with previously installed plugins order-independent.
+  std::sort(plugins.begin(),
+            plugins.end(),
+            [](const InstalledPlugin& lhs, const InstalledPlugin& rhs) {
+              return lhs.name < rhs.name;
+            });
+
   return plugins;
 }
 
+void Game::UpdatePluginCache(
+    const std::vector<InstalledPlugin>& installedPlugins) {
+  for (const auto& installedPlugin : installedPlugins) {
+    auto plugin = GetPlugin(installedPlugin.name);
+    if (plugin) {
+      pluginCache_.Update(installedPlugin, *plugin);
+    }
+  }
+
+  pluginCache_.Retain(installedPlugins);
+  pluginCache_.Save();
+}
+
+void Game::ClearMetadataPaths() {
+  lock_guard<mutex> guard(metadataPathsMutex_);
+  metadataPaths_.reset();
+}
+
 void Game::AppendMessages(std::vector<Message> messages) {
   for (auto message : messages) {
     AppendMessage(message);
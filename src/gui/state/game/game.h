@@ -27,12 +27,23 @@
 #define LOOT_GUI_STATE_GAME_GAME
 
 #include <filesystem>
+#include <functional>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 
+#include "gui/state/cancellation_token.h"
+#include "gui/state/game/background_plugin_loader.h"
+#include "gui/state/game/condition_cache.h"
+#include "gui/state/game/data_directory_index.h"
+#include "gui/state/game/derived_metadata_cache.h"
+#include "gui/state/game/form_id_overlap_cache.h"
 #include "gui/state/game/game_settings.h"
+#include "gui/state/game/load_order_index_table.h"
+#include "gui/state/game/metadata_paths.h"
+#include "gui/state/game/plugin_cache.h"
 #include "loot/api.h"
 
 namespace loot {
@@ -55,14 +66,49 @@ public:
   std::vector<Message> CheckInstallValidity(
       const std::shared_ptr<const PluginInterface>& plugin,
       const PluginMetadata& metadata);
+  // Checks for files using the given index, and memoizes the results of
+  // file and active state checks in the given cache, which can be shared
+  // between the checks for many plugins.
+  std::vector<Message> CheckInstallValidity(
+      const std::shared_ptr<const PluginInterface>& plugin,
+      const PluginMetadata& metadata,
+      const DataDirectoryIndex& dataDirectoryIndex,
+      ConditionCache& conditionCache);
+
+  // Create a snapshot of the contents of the game's data directory, for
+  // checking many plugins' install validity without repeatedly hitting the
+  // filesystem.
+  std::shared_ptr<const DataDirectoryIndex> IndexDataDirectory() const;
 
   void RedatePlugins();  // Change timestamps to match load order (Skyrim only).
 
+  // Loads all installed plugins. Cancelling the load leaves the previously
+  // loaded plugins in place.
   void LoadAllInstalledPlugins(
-      bool headersOnly);  // Loads all installed plugins.
+      bool headersOnly,
+      const CancellationToken& cancellationToken = CancellationToken());
   bool ArePluginsFullyLoaded()
       const;  // Checks if the game's plugins have already been loaded.
 
+  // Start fully loading the installed plugins on a background thread, if they
+  // are not already fully loaded.
+  void StartBackgroundFullLoad();
+
+  // Stop any background full load, e.g. because the game is no longer
+  // current. Its plugins are then fully loaded when they're next needed.
+  void CancelBackgroundFullLoad();
+  // Wait for any background load to finish, falling back to fully loading the
+  // installed plugins if there is none or it failed.
+  void WaitForFullyLoadedPlugins(
+      const BackgroundPluginLoader::ProgressCallback& onProgress,
+      const CancellationToken& cancellationToken = CancellationToken());
+
+  // Get the normalised filenames of the loaded plugins that have FormIDs
+  // overlapping with the given plugin's. Results are remembered while the
+  // plugins are fully loaded and unchanged.
+  std::shared_ptr<const FormIdOverlapCache::OverlappingPlugins>
+  GetOverlappingPlugins(const PluginInterface& plugin) const;
+
   std::filesystem::path MasterlistPath() const;
   std::filesystem::path UserlistPath() const;
   std::filesystem::path PluginsTxtPath() const;
@@ -74,6 +120,10 @@ public:
   std::optional<short> GetActiveLoadOrderIndex(
       const std::shared_ptr<const PluginInterface>& plugin,
       const std::vector<std::string>& loadOrder) const;
+  // Calculates the active load order indices of all plugins in the given load
+  // order in a single pass.
+  LoadOrderIndexTable GetActiveLoadOrderIndices(
+      const std::vector<std::string>& loadOrder) const;
 
   std::vector<std::string> SortPlugins();
   void IncrementLoadOrderSortCount();
@@ -87,6 +137,10 @@ public:
   MasterlistInfo GetMasterlistInfo() const;
 
   void LoadMetadata();
+  // Checks if the masterlist or userlist has been changed, added or removed
+  // since the metadata lists were last loaded, or if they have not been
+  // loaded since the game was initialised.
+  bool HaveMetadataListsChanged() const;
   std::vector<std::string> GetKnownBashTags() const;
 
   std::vector<Group> GetMasterlistGroups() const;
@@ -99,14 +153,46 @@ public:
       const std::string& pluginName,
       bool evaluateConditions = false) const;
 
+  // The cache is cleared or has entries invalidated whenever metadata or the
+  // load order is changed through this object.
+  DerivedMetadataCache& GetDerivedMetadataCache() const;
+
+  // Get the paths that the loaded plugins' metadata reads. They are found
+  // once and then reused until the metadata or the loaded plugins change.
+  std::shared_ptr<const MetadataPaths> GetMetadataPaths() const;
+
   void SetUserGroups(const std::vector<Group>& groups);
   void AddUserMetadata(const PluginMetadata& metadata);
   void ClearUserMetadata(const std::string& pluginName);
   void ClearAllUserMetadata();
   void SaveUserMetadata();
 
+  // A rough estimate of the memory used by the game's loaded plugins,
+  // metadata and derived metadata cache, for deciding whether to keep it
+  // initialised when it is not the current game.
+  size_t EstimateMemoryUsage() const;
+
 private:
-  std::vector<std::string> GetInstalledPluginNames();
+  // The last write times of the masterlist and userlist, or nullopt for a
+  // list that does not exist.
+  struct MetadataListsState {
+    std::optional<std::filesystem::file_time_type> masterlist;
+    std::optional<std::filesystem::file_time_type> userlist;
+
+    bool operator==(const MetadataListsState& other) const {
+      return masterlist == other.masterlist && userlist == other.userlist;
+    }
+  };
+
+  MetadataListsState GetMetadataListsState() const;
+  std::vector<InstalledPlugin> GetInstalledPlugins();
+  std::vector<Message> CheckInstallValidity(
+      const std::shared_ptr<const PluginInterface>& plugin,
+      const PluginMetadata& metadata,
+      const std::function<bool(const std::string&)>& fileExists,
+      const std::function<bool(const std::string&)>& isActive);
+  void UpdatePluginCache(const std::vector<InstalledPlugin>& installedPlugins);
+  void ClearMetadataPaths();
   void AppendMessages(std::vector<Message> messages);
 
   std::shared_ptr<GameInterface> gameHandle_;
@@ -114,6 +200,20 @@ private:
   std::filesystem::path lootDataPath_;
   unsigned short loadOrderSortCount_;
   bool pluginsFullyLoaded_;
+  // The installed plugins as they were when the plugins were last loaded.
+  std::vector<InstalledPlugin> loadedPlugins_;
+  PluginCache pluginCache_;
+  mutable FormIdOverlapCache formIdOverlapCache_;
+  mutable DerivedMetadataCache derivedMetadataCache_;
+  mutable std::shared_ptr<const MetadataPaths> metadataPaths_;
+  mutable std::mutex metadataPathsMutex_;
+  // Plugins that were last loaded from the plugin cache or by a background
+  // load instead of by the game handle, keyed by their normalised filenames.
+  std::unordered_map<std::string, std::shared_ptr<const PluginInterface>>
+      externallyLoadedPlugins_;
+  std::shared_ptr<BackgroundPluginLoader> backgroundLoader_;
+  // The state of the metadata lists as they were when they were last loaded.
+  std::optional<MetadataListsState> loadedListsState_;
 
   mutable std::mutex mutex_;
 };
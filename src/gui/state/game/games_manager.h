@@ -26,11 +26,18 @@
 #ifndef LOOT_GUI_STATE_GAME_GAMES_MANAGER
 #define LOOT_GUI_STATE_GAME_GAMES_MANAGER
 
+#include <chrono>
 #include <filesystem>
+#include <functional>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <boost/locale.hpp>
@@ -43,9 +50,43 @@
 namespace loot {
 class GamesManager {
 public:
-  GamesManager() : currentGame_(installedGames_.end()) {}
+  // Game detection may probe paths on slow or disconnected network drives, so
+  // don't let any one game hold up startup for longer than this.
+  static constexpr std::chrono::milliseconds DEFAULT_GAME_DETECTION_TIMEOUT =
+      std::chrono::seconds(2);
+
+  // Finds the path of the given game, if it's installed. It's run on its own
+  // thread and may still be running after LoadInstalledGames() returns if it
+  // timed out, so it must not refer to anything that it doesn't own.
+  typedef std::function<std::optional<std::filesystem::path>(
+      const GameSettings&)>
+      GamePathFinder;
+
+  explicit GamesManager(GamePathFinder findGamePath) :
+      findGamePath_(findGamePath),
+      gameDetectionTimeout_(DEFAULT_GAME_DETECTION_TIMEOUT),
+      inactiveGamesMemoryBudget_(0) {}
+
+  void SetGameDetectionTimeout(std::chrono::milliseconds timeout) {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+
+    gameDetectionTimeout_ = timeout;
+  }
+
+  // Games that are no longer current are kept initialised, so that switching
+  // back to them is fast, as long as their estimated memory usage fits within
+  // the budget. The least recently used games are discarded first. A budget
+  // of zero discards games as soon as they stop being current.
+  void SetInactiveGamesMemoryBudget(size_t bytes) {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+
+    inactiveGamesMemoryBudget_ = bytes;
+    EvictInactiveGames();
+  }
 
   // Installed games have their game paths set in the returned settings.
+  // Installed games are recorded by their settings, and a gui::Game object is
+  // only constructed for a game when it becomes current.
   std::vector<GameSettings> LoadInstalledGames(
       std::vector<GameSettings> gamesSettings,
       const std::filesystem::path& lootDataPath) {
@@ -53,54 +94,52 @@ public:
 
     auto logger = getLogger();
 
-    std::optional<std::string> currentGameFolder;
-    if (currentGame_ != installedGames_.end()) {
-      currentGameFolder = currentGame_->FolderName();
-    }
+    auto gamePaths = FindGamePaths(gamesSettings);
 
-    bool currentGameUpdated = false;
-    std::vector<gui::Game> installedGames;
-    for (auto& gameSettings : gamesSettings) {
-      auto gamePath = FindGamePath(gameSettings);
+    std::vector<GameSettings> installedGames;
+    for (size_t i = 0; i < gamesSettings.size(); ++i) {
+      auto& gameSettings = gamesSettings[i];
+      auto& gamePath = gamePaths[i];
       if (!gamePath.has_value()) {
         continue;
       }
       gameSettings.SetGamePath(gamePath.value());
 
-      if (currentGameFolder.has_value() &&
-          currentGameFolder.value() == gameSettings.FolderName() &&
-          !GameNeedsRecreating(GetCurrentGame(), gameSettings)) {
-        if (logger) {
-          logger->trace("Updating game entry for: {}",
-                        gameSettings.FolderName());
-        }
+      if (logger) {
+        logger->trace("Found installed game: {}", gameSettings.FolderName());
+      }
 
-        GetCurrentGame()
-            .SetName(gameSettings.Name())
-            .SetMinimumHeaderVersion(gameSettings.MinimumHeaderVersion())
-            .SetRegistryKey(gameSettings.RegistryKey())
-            .SetRepoURL(gameSettings.RepoURL())
-            .SetRepoBranch(gameSettings.RepoBranch());
+      installedGames.push_back(gameSettings);
+    }
+    installedGames_ = installedGames;
+    lootDataPath_ = lootDataPath;
 
-        installedGames.push_back(GetCurrentGame());
-        currentGameUpdated = true;
+    for (auto it = inactiveGames_.begin(); it != inactiveGames_.end();) {
+      auto newSettings = FindInstalledGame((*it)->FolderName());
+      if (newSettings == installedGames_.end() ||
+          GameNeedsRecreating(**it, *newSettings)) {
+        it = inactiveGames_.erase(it);
       } else {
-        if (logger) {
-          logger->trace("Adding new installed game entry for: {}",
-                        gameSettings.FolderName());
-        }
-
-        installedGames.push_back(gui::Game(gameSettings, lootDataPath));
+        UpdateGame(**it, *newSettings);
+        ++it;
       }
     }
-    installedGames_ = installedGames;
 
-    if (currentGameUpdated) {
-      SetCurrentGameWithoutInit(currentGameFolder.value());
-    } else if (currentGameFolder.has_value()) {
-      SetCurrentGame(currentGameFolder.value());
+    if (!currentGame_) {
+      return gamesSettings;
+    }
+
+    auto currentGameFolder = currentGame_->FolderName();
+    auto newSettings = FindInstalledGame(currentGameFolder);
+    if (newSettings != installedGames_.end() &&
+        !GameNeedsRecreating(*currentGame_, *newSettings)) {
+      if (logger) {
+        logger->trace("Updating game entry for: {}", currentGameFolder);
+      }
+
+      UpdateGame(*currentGame_, *newSettings);
     } else {
-      currentGame_ = installedGames_.end();
+      SetCurrentGame(currentGameFolder);
     }
 
     return gamesSettings;
@@ -109,7 +148,7 @@ public:
   gui::Game& GetCurrentGame() {
     std::lock_guard<std::recursive_mutex> guard(mutex_);
 
-    if (currentGame_ == installedGames_.end()) {
+    if (!currentGame_) {
       throw std::runtime_error("No current game to get.");
     }
 
@@ -119,7 +158,7 @@ public:
   const gui::Game& GetCurrentGame() const {
     std::lock_guard<std::recursive_mutex> guard(mutex_);
 
-    if (currentGame_ == installedGames_.end()) {
+    if (!currentGame_) {
       throw std::runtime_error("No current game to get.");
     }
 
@@ -127,22 +166,27 @@ public:
   }
 
   void SetCurrentGame(const std::string& newGameFolder) {
-    SetCurrentGameWithoutInit(newGameFolder);
-    InitialiseGameData(GetCurrentGame());
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+
+    if (!SetCurrentGameWithoutInit(newGameFolder)) {
+      InitialiseGameData(GetCurrentGame());
+    }
   }
 
   std::vector<std::string> GetInstalledGameFolderNames() const {
     std::lock_guard<std::recursive_mutex> guard(mutex_);
 
     std::vector<std::string> installedGames;
-    for (const auto& game : installedGames_) {
-      installedGames.push_back(game.FolderName());
+    for (const auto& gameSettings : installedGames_) {
+      installedGames.push_back(gameSettings.FolderName());
     }
 
     return installedGames;
   }
 
   std::optional<std::string> GetFirstInstalledGameFolderName() const {
+    std::lock_guard<std::recursive_mutex> guard(mutex_);
+
     if (!installedGames_.empty()) {
       return installedGames_.front().FolderName();
     }
@@ -151,9 +195,87 @@ public:
   }
 
 private:
-  virtual std::optional<std::filesystem::path> FindGamePath(
-      const GameSettings& gameSettings) const = 0;
+  typedef std::shared_future<std::optional<std::filesystem::path>>
+      GamePathFuture;
+
   virtual void InitialiseGameData(gui::Game& game) = 0;
+  virtual size_t EstimateMemoryUsage(const gui::Game& game) const = 0;
+
+  // Runs game detection for all the given games concurrently, and returns
+  // their paths in the same order as the given settings. Games that aren't
+  // detected within the timeout are treated as not installed, apart from the
+  // current game, which keeps its current path.
+  std::vector<std::optional<std::filesystem::path>> FindGamePaths(
+      const std::vector<GameSettings>& gamesSettings) {
+    std::vector<GamePathFuture> futures;
+    futures.reserve(gamesSettings.size());
+    for (const auto& gameSettings : gamesSettings) {
+      // Wait on a probe that timed out last time and is still running instead
+      // of starting another, so that a game whose probe hangs only ever ties
+      // up one thread.
+      auto pendingProbe = pendingProbes_.find(gameSettings.FolderName());
+      if (pendingProbe != pendingProbes_.end()) {
+        if (pendingProbe->second.wait_for(std::chrono::seconds(0)) !=
+            std::future_status::ready) {
+          futures.push_back(pendingProbe->second);
+          continue;
+        }
+        pendingProbes_.erase(pendingProbe);
+      }
+
+      // The task owns copies of everything it uses, so a probe that times out
+      // can safely outlive this object.
+      std::packaged_task<std::optional<std::filesystem::path>()> task(
+          [findGamePath = findGamePath_, gameSettings]() {
+            return findGamePath(gameSettings);
+          });
+      futures.push_back(task.get_future().share());
+
+      // Detach so that a probe that hangs doesn't block on the future's
+      // destruction, its result will just be discarded.
+      std::thread(std::move(task)).detach();
+    }
+
+    auto logger = getLogger();
+    const auto deadline =
+        std::chrono::steady_clock::now() + gameDetectionTimeout_;
+
+    std::vector<std::optional<std::filesystem::path>> gamePaths;
+    gamePaths.reserve(gamesSettings.size());
+    for (size_t i = 0; i < futures.size(); ++i) {
+      const auto folderName = gamesSettings[i].FolderName();
+      if (futures[i].wait_until(deadline) == std::future_status::ready) {
+        pendingProbes_.erase(folderName);
+        gamePaths.push_back(futures[i].get());
+        continue;
+      }
+
+      pendingProbes_.emplace(folderName, futures[i]);
+
+      if (currentGame_ && currentGame_->FolderName() == folderName) {
+        if (logger) {
+          logger->warn(
+              "Timed out after {} ms while checking if the current game \"{}\" "
+              "is still installed, keeping its current path.",
+              gameDetectionTimeout_.count(),
+              gamesSettings[i].Name());
+        }
+        gamePaths.push_back(currentGame_->GamePath());
+        continue;
+      }
+
+      if (logger) {
+        logger->warn(
+            "Timed out after {} ms while checking if game \"{}\" is "
+            "installed, treating it as not installed.",
+            gameDetectionTimeout_.count(),
+            gamesSettings[i].Name());
+      }
+      gamePaths.push_back(std::nullopt);
+    }
+
+    return gamePaths;
+  }
 
   static bool GameNeedsRecreating(const gui::Game& game,
                                   const GameSettings& newSettings) {
@@ -162,35 +284,117 @@ private:
            game.Master() != newSettings.Master();
   }
 
-  void SetCurrentGameWithoutInit(const std::string& newGameFolder) {
+  // Updates the settings that can change without the game being recreated.
+  static void UpdateGame(gui::Game& game, const GameSettings& newSettings) {
+    game.SetName(newSettings.Name())
+        .SetMinimumHeaderVersion(newSettings.MinimumHeaderVersion())
+        .SetRegistryKey(newSettings.RegistryKey())
+        .SetRepoURL(newSettings.RepoURL())
+        .SetRepoBranch(newSettings.RepoBranch());
+  }
+
+  std::vector<GameSettings>::const_iterator FindInstalledGame(
+      const std::string& folderName) const {
+    return find_if(installedGames_.cbegin(),
+                   installedGames_.cend(),
+                   [&](const GameSettings& gameSettings) {
+                     return folderName == gameSettings.FolderName();
+                   });
+  }
+
+  // Returns true if the new current game was kept initialised from when it was
+  // last current, and false if it needs initialising.
+  bool SetCurrentGameWithoutInit(const std::string& newGameFolder) {
     auto logger = getLogger();
     if (logger) {
       logger->debug("Setting the current game to that with folder: {}",
                     newGameFolder);
     }
 
-    currentGame_ = find_if(
-        installedGames_.begin(), installedGames_.end(), [&](const gui::Game& game) {
-          return newGameFolder == game.FolderName();
-        });
-
-    if (currentGame_ == installedGames_.end()) {
-      logger->error(
-          "Cannot set the current game: the game with folder \"{}\" is not "
-          "installed.",
-          newGameFolder);
+    auto gameSettings = FindInstalledGame(newGameFolder);
+    if (gameSettings == installedGames_.end()) {
+      if (logger) {
+        logger->error(
+            "Cannot set the current game: the game with folder \"{}\" is not "
+            "installed.",
+            newGameFolder);
+      }
       throw GameDetectionError(
           "Cannot set the current game: the game with folder \"" +
           newGameFolder + "\" cannot be found. If it is installed, try running the game's launcher to register its location.");
     }
 
+    // Switching can no longer fail, so keep the current game initialised.
+    if (currentGame_) {
+      currentGame_->CancelBackgroundFullLoad();
+      inactiveGames_.push_front(std::move(currentGame_));
+    }
+
+    auto inactiveGame = find_if(inactiveGames_.begin(),
+                                inactiveGames_.end(),
+                                [&](const std::unique_ptr<gui::Game>& game) {
+                                  return newGameFolder == game->FolderName();
+                                });
+    bool isInitialised = false;
+    if (inactiveGame != inactiveGames_.end()) {
+      if (!GameNeedsRecreating(**inactiveGame, *gameSettings)) {
+        currentGame_ = std::move(*inactiveGame);
+        isInitialised = true;
+      }
+      inactiveGames_.erase(inactiveGame);
+    }
+
+    if (!currentGame_) {
+      currentGame_ = std::make_unique<gui::Game>(*gameSettings, lootDataPath_);
+    }
+
+    EvictInactiveGames();
+
     if (logger) {
       logger->debug("New game is: {}", currentGame_->Name());
+      if (isInitialised) {
+        logger->debug("Reusing the game's data from when it was last current.");
+      }
     }
+
+    return isInitialised;
+  }
+
+  void EvictInactiveGames() {
+    size_t memoryUsage = 0;
+    auto it = inactiveGames_.begin();
+    for (; it != inactiveGames_.end(); ++it) {
+      memoryUsage += EstimateMemoryUsage(**it);
+      if (memoryUsage > inactiveGamesMemoryBudget_) {
+        break;
+      }
+    }
+
+    auto logger = getLogger();
+    for (auto evicted = it; evicted != inactiveGames_.end(); ++evicted) {
+      (*evicted)->CancelBackgroundFullLoad();
+      if (logger) {
+        logger->debug(
+            "Discarding the data for game \"{}\" to stay within the memory "
+            "budget for inactive games.",
+            (*evicted)->Name());
+      }
+    }
+
+    inactiveGames_.erase(it, inactiveGames_.end());
   }
 
-  std::vector<gui::Game> installedGames_;
-  std::vector<gui::Game>::iterator currentGame_;
+  std::vector<GameSettings> installedGames_;
+  std::filesystem::path lootDataPath_;
+  std::unique_ptr<gui::Game> currentGame_;
+  const GamePathFinder findGamePath_;
+  // Previously current games that are still initialised, most recently used
+  // first.
+  std::list<std::unique_ptr<gui::Game>> inactiveGames_;
+  std::chrono::milliseconds gameDetectionTimeout_;
+  // Probes that timed out and may still be running, keyed by game folder name.
+  std::map<std::string, GamePathFuture> pendingProbes_;
+  size_t inactiveGamesMemoryBudget_;
 
   // Mutex used to protect access to member variables.
   mutable std::recursive_mutex mutex_;
@@ -25,14 +25,31 @@
 
 #include "gui/state/game/helpers.h"
 
+#include <algorithm>
+#include <array>
 #include <fstream>
-#include <regex>
+#include <string_view>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
 #include <boost/locale.hpp>
 
 namespace loot {
+namespace {
+// Lookup table for the characters that EscapeMarkdownSpecialChars escapes.
+constexpr std::array<bool, 256> MARKDOWN_SPECIAL_CHARS = []() {
+  std::array<bool, 256> table{};
+  for (unsigned char c : std::string_view("\\`*_{}[]()#+-.!")) {
+    table[c] = true;
+  }
+  return table;
+}();
+
+bool IsMarkdownSpecialChar(char c) {
+  return MARKDOWN_SPECIAL_CHARS[static_cast<unsigned char>(c)];
+}
+}
+
 bool ExecutableExists(const GameType& gameType,
                       const std::filesystem::path& gamePath) {
   if (gameType == GameType::tes5) {
@@ -74,9 +91,26 @@ Message PlainTextMessage(MessageType type, std::string text) {
   return Message(type, EscapeMarkdownSpecialChars(text));
 }
 
-std::string EscapeMarkdownSpecialChars(std::string text) { 
-  auto specialCharsRegex = std::regex("([\\\\`*_{}\\[\\]()#+.!-])");
-  return std::regex_replace(text, specialCharsRegex, "\\$1");
+std::string EscapeMarkdownSpecialChars(std::string text) {
+  auto specialCharCount =
+      std::count_if(text.begin(), text.end(), IsMarkdownSpecialChar);
+  if (specialCharCount == 0) {
+    return text;
+  }
+
+  std::string escaped(text.size() + specialCharCount, '\\');
+  auto out = escaped.begin();
+  for (const auto c : text) {
+    // The output is pre-filled with backslashes, so an escaped character
+    // only needs to skip over one.
+    if (IsMarkdownSpecialChar(c)) {
+      ++out;
+    }
+    *out = c;
+    ++out;
+  }
+
+  return escaped;
 }
 
 Message ToMessage(const PluginCleaningData& cleaningData) {
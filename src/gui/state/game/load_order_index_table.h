@@ -0,0 +1,83 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_LOAD_ORDER_INDEX_TABLE
+#define LOOT_GUI_STATE_GAME_LOAD_ORDER_INDEX_TABLE
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "gui/helpers.h"
+
+namespace loot {
+// Holds the active load order indices of plugins in a load order, so that
+// they can be looked up without walking the load order for each plugin.
+// Light plugins are indexed separately from full plugins, as the two occupy
+// different parts of the game's index space.
+class LoadOrderIndexTable {
+public:
+  void AddActivePlugin(const std::string& pluginName, bool isLightPlugin) {
+    auto& nextIndex = isLightPlugin ? nextLightIndex_ : nextFullIndex_;
+    auto normalizedName = NormalizeFilename(pluginName);
+    auto inserted = indices_.emplace(normalizedName, nextIndex).second;
+
+    // Only the first occurrence of a plugin in the load order counts.
+    if (inserted) {
+      ++nextIndex;
+      // Summing the hashes makes the fingerprint independent of load order.
+      activePluginsFingerprint_ += std::hash<std::string>()(normalizedName);
+    }
+  }
+
+  std::optional<short> GetIndex(const std::string& pluginName) const {
+    auto it = indices_.find(NormalizeFilename(pluginName));
+    if (it == indices_.end()) {
+      return std::nullopt;
+    }
+
+    return it->second;
+  }
+
+  short GetActiveFullPluginCount() const { return nextFullIndex_; }
+
+  short GetActiveLightPluginCount() const { return nextLightIndex_; }
+
+  // Summarises which plugins are active, so that tables for load orders with
+  // the same active plugins have the same fingerprint, whatever their order.
+  size_t GetActivePluginsFingerprint() const {
+    return activePluginsFingerprint_;
+  }
+
+private:
+  std::unordered_map<std::string, short> indices_;
+  short nextFullIndex_ = 0;
+  short nextLightIndex_ = 0;
+  size_t activePluginsFingerprint_ = 0;
+};
+}
+
+#endif
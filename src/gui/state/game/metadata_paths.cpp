@@ -0,0 +1,149 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/game/metadata_paths.h"
+
+#include <optional>
+#include <unordered_map>
+
+#include "gui/helpers.h"
+#include "gui/state/game/data_directory_index.h"
+
+namespace loot {
+namespace {
+// Ordered so that the greater use wins when a path is used in more than one
+// way.
+enum class PathUse { activity, existence, content };
+
+// Condition functions take a path as their first argument, which is a quoted
+// string, and how the path is read depends on the function. Returns nullopt
+// if the quoted string isn't a function's first argument (e.g. a version).
+std::optional<PathUse> getPathUse(const std::string& condition,
+                                  size_t quotePos) {
+  auto openPos = condition.rfind('(', quotePos);
+  if (openPos == std::string::npos) {
+    return PathUse::content;
+  }
+  if (condition.find('"', openPos) != quotePos) {
+    return std::nullopt;
+  }
+
+  auto nameEnd = condition.find_last_not_of(' ', openPos - 1);
+  if (openPos == 0 || nameEnd == std::string::npos) {
+    return PathUse::content;
+  }
+
+  auto nameStart =
+      condition.find_last_not_of("abcdefghijklmnopqrstuvwxyz_", nameEnd);
+  nameStart = nameStart == std::string::npos ? 0 : nameStart + 1;
+  auto name = condition.substr(nameStart, nameEnd + 1 - nameStart);
+
+  if (name == "file" || name == "many") {
+    return PathUse::existence;
+  }
+  if (name == "active" || name == "many_active") {
+    return PathUse::activity;
+  }
+
+  return PathUse::content;
+}
+
+void addPath(const std::string& path,
+             PathUse use,
+             std::unordered_map<std::string, PathUse>& paths) {
+  auto it = paths.emplace(path, use).first;
+  if (it->second < use) {
+    it->second = use;
+  }
+}
+
+void addConditionPaths(const std::string& condition,
+                       std::unordered_map<std::string, PathUse>& paths) {
+  auto start = condition.find('"');
+  while (start != std::string::npos) {
+    auto end = condition.find('"', start + 1);
+    if (end == std::string::npos) {
+      break;
+    }
+
+    auto use = getPathUse(condition, start);
+    if (use.has_value()) {
+      addPath(condition.substr(start + 1, end - start - 1), use.value(), paths);
+    }
+    start = condition.find('"', end + 1);
+  }
+}
+
+void addMetadataPaths(const PluginMetadata& metadata,
+                      std::unordered_map<std::string, PathUse>& paths) {
+  for (const auto& message : metadata.GetMessages()) {
+    addConditionPaths(message.GetCondition(), paths);
+  }
+  for (const auto& tag : metadata.GetTags()) {
+    addConditionPaths(tag.GetCondition(), paths);
+  }
+  for (const auto& file : metadata.GetLoadAfterFiles()) {
+    addConditionPaths(file.GetCondition(), paths);
+  }
+  // Install validity checks look for requirements and incompatibilities.
+  for (const auto& files :
+       {metadata.GetRequirements(), metadata.GetIncompatibilities()}) {
+    for (const auto& file : files) {
+      addConditionPaths(file.GetCondition(), paths);
+      addPath(std::string(file.GetName()), PathUse::existence, paths);
+    }
+  }
+}
+}
+
+MetadataPaths FindMetadataPaths(
+    const std::vector<std::shared_ptr<const PluginInterface>>& loadedPlugins,
+    const std::vector<PluginMetadata>& metadata) {
+  std::unordered_map<std::string, PathUse> paths;
+  for (const auto& pluginMetadata : metadata) {
+    addMetadataPaths(pluginMetadata, paths);
+  }
+
+  std::unordered_map<std::string, std::string> loadedPluginNames;
+  for (const auto& plugin : loadedPlugins) {
+    loadedPluginNames.emplace(NormalizeFilename(plugin->GetName()),
+                              plugin->GetName());
+  }
+
+  MetadataPaths metadataPaths;
+  for (const auto& [path, use] : paths) {
+    auto it = loadedPluginNames.find(NormalizeFilename(path));
+    if (it != loadedPluginNames.end()) {
+      metadataPaths.plugins.insert(it->second);
+    } else if (use == PathUse::content ||
+               (use == PathUse::existence &&
+                !DataDirectoryIndex::CanIndex(path))) {
+      metadataPaths.files.insert(path);
+    }
+  }
+
+  return metadataPaths;
+}
+}
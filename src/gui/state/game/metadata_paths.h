@@ -0,0 +1,60 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_METADATA_PATHS
+#define LOOT_GUI_STATE_GAME_METADATA_PATHS
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "loot/api.h"
+
+namespace loot {
+// The paths that plugins' metadata conditions and install validity checks
+// read, split by how changes to them can be detected. Finding them means
+// walking all the metadata, so they should only be found again when the
+// metadata or the loaded plugins change.
+struct MetadataPaths {
+  // The names of loaded plugins that are read, as the loaded plugins return
+  // them. Their state is more reliably compared using the loaded plugins than
+  // their files.
+  std::unordered_set<std::string> plugins;
+  // Paths that need their state checked on the filesystem. This excludes the
+  // paths that are only checked for existence and can be answered by a data
+  // directory index, as its fingerprint already covers them, and the paths
+  // that are only checked for being active.
+  std::unordered_set<std::string> files;
+};
+
+// Find the paths that the given metadata reads. The metadata should be that
+// of the given loaded plugins.
+MetadataPaths FindMetadataPaths(
+    const std::vector<std::shared_ptr<const PluginInterface>>& loadedPlugins,
+    const std::vector<PluginMetadata>& metadata);
+}
+
+#endif
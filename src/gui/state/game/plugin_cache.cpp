@@ -0,0 +1,276 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#include "gui/state/game/plugin_cache.h"
+
+#include <fstream>
+
+#include <json.hpp>
+
+#include "gui/state/logging.h"
+
+namespace loot {
+// Increment this if the cache file's structure changes, so that old cache
+// files are discarded instead of being misread.
+static constexpr unsigned int PLUGIN_CACHE_VERSION = 1;
+
+CachedPlugin::CachedPlugin(const PluginInterface& plugin) :
+    name_(plugin.GetName()),
+    headerVersion_(plugin.GetHeaderVersion()),
+    version_(plugin.GetVersion()),
+    masters_(plugin.GetMasters()),
+    bashTags_(plugin.GetBashTags()),
+    crc_(plugin.GetCRC()),
+    isMaster_(plugin.IsMaster()),
+    isLightMaster_(plugin.IsLightMaster()),
+    isLightPlugin_(plugin.IsLightPlugin()),
+    isValidAsLightMaster_(plugin.IsValidAsLightMaster()),
+    isValidAsLightPlugin_(plugin.IsValidAsLightPlugin()),
+    isEmpty_(plugin.IsEmpty()),
+    loadsArchive_(plugin.LoadsArchive()) {}
+
+std::string CachedPlugin::GetName() const { return name_; }
+
+float CachedPlugin::GetHeaderVersion() const { return headerVersion_; }
+
+std::optional<std::string> CachedPlugin::GetVersion() const {
+  return version_;
+}
+
+std::vector<std::string> CachedPlugin::GetMasters() const { return masters_; }
+
+std::vector<Tag> CachedPlugin::GetBashTags() const { return bashTags_; }
+
+std::optional<uint32_t> CachedPlugin::GetCRC() const { return crc_; }
+
+bool CachedPlugin::IsMaster() const { return isMaster_; }
+
+bool CachedPlugin::IsLightMaster() const { return isLightMaster_; }
+
+bool CachedPlugin::IsLightPlugin() const { return isLightPlugin_; }
+
+bool CachedPlugin::IsValidAsLightMaster() const {
+  return isValidAsLightMaster_;
+}
+
+bool CachedPlugin::IsValidAsLightPlugin() const {
+  return isValidAsLightPlugin_;
+}
+
+bool CachedPlugin::IsEmpty() const { return isEmpty_; }
+
+bool CachedPlugin::LoadsArchive() const { return loadsArchive_; }
+
+bool CachedPlugin::DoFormIDsOverlap(const PluginInterface& plugin) const {
+  return false;
+}
+
+PluginCache::PluginCache(const std::filesystem::path& cachePath) :
+    cachePath_(cachePath) {}
+
+void PluginCache::Load() {
+  entries_.clear();
+  modified_ = false;
+
+  if (cachePath_.empty() || !std::filesystem::exists(cachePath_)) {
+    return;
+  }
+
+  auto logger = getLogger();
+
+  try {
+    std::ifstream in(cachePath_);
+    auto json = nlohmann::json::parse(in);
+
+    if (json.at("version").get<unsigned int>() != PLUGIN_CACHE_VERSION) {
+      if (logger) {
+        logger->info("Discarding plugin cache with an unsupported version.");
+      }
+      return;
+    }
+
+    for (const auto& entry : json.at("plugins")) {
+      auto plugin = std::make_shared<CachedPlugin>();
+      plugin->name_ = entry.at("name").get<std::string>();
+      plugin->headerVersion_ = entry.at("headerVersion").get<float>();
+      if (entry.count("version") != 0) {
+        plugin->version_ = entry.at("version").get<std::string>();
+      }
+      plugin->masters_ = entry.at("masters").get<std::vector<std::string>>();
+      for (const auto& tag : entry.at("bashTags")) {
+        plugin->bashTags_.push_back(Tag(tag.at("name").get<std::string>(),
+                                        tag.at("isAddition").get<bool>()));
+      }
+      if (entry.count("crc") != 0) {
+        plugin->crc_ = entry.at("crc").get<uint32_t>();
+      }
+      plugin->isMaster_ = entry.at("isMaster").get<bool>();
+      plugin->isLightMaster_ = entry.at("isLightMaster").get<bool>();
+      plugin->isLightPlugin_ = entry.at("isLightPlugin").get<bool>();
+      plugin->isValidAsLightMaster_ =
+          entry.at("isValidAsLightMaster").get<bool>();
+      plugin->isValidAsLightPlugin_ =
+          entry.at("isValidAsLightPlugin").get<bool>();
+      plugin->isEmpty_ = entry.at("isEmpty").get<bool>();
+      plugin->loadsArchive_ = entry.at("loadsArchive").get<bool>();
+
+      auto lastWriteTime = std::filesystem::file_time_type(
+          std::filesystem::file_time_type::duration(
+              entry.at("lastWriteTime").get<int64_t>()));
+
+      entries_[plugin->name_] = Entry{
+          entry.at("size").get<std::uintmax_t>(), lastWriteTime, plugin};
+    }
+  } catch (const std::exception& e) {
+    if (logger) {
+      logger->warn("Failed to read the plugin cache at \"{}\". Details: {}",
+                   cachePath_.u8string(),
+                   e.what());
+    }
+    entries_.clear();
+  }
+}
+
+void PluginCache::Save() {
+  if (cachePath_.empty() || !modified_) {
+    return;
+  }
+
+  nlohmann::json plugins = nlohmann::json::array();
+  for (const auto& [name, entry] : entries_) {
+    const auto& plugin = *entry.plugin;
+
+    nlohmann::json bashTags = nlohmann::json::array();
+    for (const auto& tag : plugin.bashTags_) {
+      bashTags.push_back(
+          {{"name", tag.GetName()}, {"isAddition", tag.IsAddition()}});
+    }
+
+    nlohmann::json json = {
+        {"name", name},
+        {"size", entry.size},
+        {"lastWriteTime",
+         static_cast<int64_t>(entry.lastWriteTime.time_since_epoch().count())},
+        {"headerVersion", plugin.headerVersion_},
+        {"masters", plugin.masters_},
+        {"bashTags", bashTags},
+        {"isMaster", plugin.isMaster_},
+        {"isLightMaster", plugin.isLightMaster_},
+        {"isLightPlugin", plugin.isLightPlugin_},
+        {"isValidAsLightMaster", plugin.isValidAsLightMaster_},
+        {"isValidAsLightPlugin", plugin.isValidAsLightPlugin_},
+        {"isEmpty", plugin.isEmpty_},
+        {"loadsArchive", plugin.loadsArchive_},
+    };
+
+    if (plugin.version_.has_value()) {
+      json["version"] = plugin.version_.value();
+    }
+
+    if (plugin.crc_.has_value()) {
+      json["crc"] = plugin.crc_.value();
+    }
+
+    plugins.push_back(json);
+  }
+
+  nlohmann::json json = {
+      {"version", PLUGIN_CACHE_VERSION},
+      {"plugins", plugins},
+  };
+
+  auto tempPath = cachePath_;
+  tempPath += ".tmp";
+
+  std::ofstream out(tempPath);
+  out << json.dump();
+  out.close();
+
+  std::error_code errorCode;
+  if (out.good()) {
+    std::filesystem::rename(tempPath, cachePath_, errorCode);
+  }
+
+  if (!out.good() || errorCode) {
+    auto logger = getLogger();
+    if (logger) {
+      logger->warn("Failed to write the plugin cache to \"{}\".",
+                   cachePath_.u8string());
+    }
+    std::filesystem::remove(tempPath, errorCode);
+    return;
+  }
+
+  modified_ = false;
+}
+
+std::shared_ptr<const PluginInterface> PluginCache::Find(
+    const InstalledPlugin& installedPlugin) const {
+  auto it = entries_.find(installedPlugin.name);
+  if (it == entries_.end() || it->second.size != installedPlugin.size ||
+      it->second.lastWriteTime != installedPlugin.lastWriteTime) {
+    return nullptr;
+  }
+
+  return it->second.plugin;
+}
+
+void PluginCache::Update(const InstalledPlugin& installedPlugin,
+                         const PluginInterface& plugin) {
+  // Keep the existing cached plugin if it's still valid, so that the same
+  // object is shared across reloads and anything keyed on it stays valid.
+  auto it = entries_.find(installedPlugin.name);
+  if (it != entries_.end() && it->second.size == installedPlugin.size &&
+      it->second.lastWriteTime == installedPlugin.lastWriteTime &&
+      (it->second.plugin->GetCRC().has_value() ||
+       !plugin.GetCRC().has_value())) {
+    return;
+  }
+
+  entries_[installedPlugin.name] =
+      Entry{installedPlugin.size,
+            installedPlugin.lastWriteTime,
+            std::make_shared<CachedPlugin>(plugin)};
+  modified_ = true;
+}
+
+void PluginCache::Retain(const std::vector<InstalledPlugin>& installedPlugins) {
+  std::map<std::string, Entry> retained;
+  for (const auto& installedPlugin : installedPlugins) {
+    auto it = entries_.find(installedPlugin.name);
+    if (it != entries_.end()) {
+      retained.insert(*it);
+    }
+  }
+
+  if (retained.size() != entries_.size()) {
+    modified_ = true;
+  }
+
+  entries_ = std::move(retained);
+}
+
+size_t PluginCache::Size() const { return entries_.size(); }
+}
@@ -0,0 +1,141 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_GUI_STATE_GAME_PLUGIN_CACHE
+#define LOOT_GUI_STATE_GAME_PLUGIN_CACHE
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "loot/api.h"
+
+namespace loot {
+// The state of an installed plugin file that, if unchanged, means the
+// plugin's data doesn't need to be read again.
+struct InstalledPlugin {
+  std::string name;
+  std::uintmax_t size;
+  std::filesystem::file_time_type lastWriteTime;
+
+  bool operator==(const InstalledPlugin& other) const {
+    return name == other.name && size == other.size &&
+           lastWriteTime == other.lastWriteTime;
+  }
+};
+
+// A plugin whose data was read from the plugin cache instead of its file.
+// FormIDs aren't cached, so it behaves like a plugin that only had its
+// header loaded when checking for overlapping FormIDs.
+class CachedPlugin : public PluginInterface {
+public:
+  CachedPlugin() = default;
+  explicit CachedPlugin(const PluginInterface& plugin);
+
+  std::string GetName() const override;
+  float GetHeaderVersion() const override;
+  std::optional<std::string> GetVersion() const override;
+  std::vector<std::string> GetMasters() const override;
+  std::vector<Tag> GetBashTags() const override;
+  std::optional<uint32_t> GetCRC() const override;
+
+  bool IsMaster() const override;
+  bool IsLightMaster() const override;
+  bool IsLightPlugin() const override;
+  bool IsValidAsLightMaster() const override;
+  bool IsValidAsLightPlugin() const override;
+  bool IsEmpty() const override;
+  bool LoadsArchive() const override;
+  bool DoFormIDsOverlap(const PluginInterface& plugin) const override;
+
+private:
+  friend class PluginCache;
+
+  std::string name_;
+  float headerVersion_ = 0.0f;
+  std::optional<std::string> version_;
+  std::vector<std::string> masters_;
+  std::vector<Tag> bashTags_;
+  std::optional<uint32_t> crc_;
+  bool isMaster_ = false;
+  bool isLightMaster_ = false;
+  bool isLightPlugin_ = false;
+  bool isValidAsLightMaster_ = false;
+  bool isValidAsLightPlugin_ = false;
+  bool isEmpty_ = false;
+  bool loadsArchive_ = false;
+};
+
+// Persists plugins' header data and CRCs between LOOT sessions, keyed on
+// each plugin file's name, size and last write time, so that unchanged
+// plugins don't need to be read again.
+class PluginCache {
+public:
+  PluginCache() = default;
+  explicit PluginCache(const std::filesystem::path& cachePath);
+
+  // Read the cache file. A missing or invalid cache file results in an empty
+  // cache.
+  void Load();
+
+  // Write the cache file if its data has changed since it was last loaded or
+  // saved. The data is written to a temporary file that then replaces the
+  // cache file, so an interrupted write can't leave a truncated cache file.
+  void Save();
+
+  // Returns nullptr if there is no data cached for the plugin file in its
+  // current state.
+  std::shared_ptr<const PluginInterface> Find(
+      const InstalledPlugin& installedPlugin) const;
+
+  // Cache the given plugin's data for the plugin file in its current state.
+  // If the data is already cached for that state, the cached data is kept
+  // unless it lacks a CRC that the given plugin has.
+  void Update(const InstalledPlugin& installedPlugin,
+              const PluginInterface& plugin);
+
+  // Remove any cached data for plugins that aren't installed.
+  void Retain(const std::vector<InstalledPlugin>& installedPlugins);
+
+  size_t Size() const;
+
+private:
+  struct Entry {
+    std::uintmax_t size;
+    std::filesystem::file_time_type lastWriteTime;
+    std::shared_ptr<const CachedPlugin> plugin;
+  };
+
+  std::filesystem::path cachePath_;
+  std::map<std::string, Entry> entries_;
+  bool modified_ = false;
+};
+}
+
+#endif
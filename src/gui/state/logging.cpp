@@ -25,11 +25,174 @@
 
 #include "gui/state/logging.h"
 
-#include <spdlog/sinks/basic_file_sink.h>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+#include <spdlog/async.h>
+#include <spdlog/details/file_helper.h>
+#include <spdlog/sinks/base_sink.h>
+#include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/sinks/stdout_sinks.h>
+#include <zlib.h>
 
 namespace loot {
 static const char* LOGGER_NAME = "loot_logger";
+// The number of messages that can be queued for writing before the overflow
+// policy applies.
+static constexpr size_t LOG_QUEUE_SIZE = 8192;
+// How often queued messages are flushed to the log file.
+static constexpr std::chrono::seconds LOG_FLUSH_INTERVAL(1);
+
+// Rotating log files on open involves renaming them, so wait until the first
+// message is written to open the log file. With an async logger that happens
+// on its background thread, so startup doesn't wait for any file operations.
+// Rotated log files are gzip-compressed, which also happens on that thread.
+class DeferredRotatingFileSink : public spdlog::sinks::base_sink<std::mutex> {
+public:
+  DeferredRotatingFileSink(const spdlog::filename_t& filename,
+                           size_t maxFileSize,
+                           size_t maxRotatedFiles) :
+      filename_(filename),
+      maxFileSize_(maxFileSize),
+      maxRotatedFiles_(maxRotatedFiles) {}
+
+protected:
+  void sink_it_(const spdlog::details::log_msg& msg) override {
+    if (!fileOpened_) {
+      fileOpened_ = true;
+      // Keep the previous session's log. If it can't be rotated (e.g.
+      // because another process has it open), just append to it and don't
+      // try rotating it again.
+      canRotate_ = rotateFiles();
+      openFile(canRotate_);
+    }
+
+    if (!isOpen_) {
+      return;
+    }
+
+    spdlog::memory_buf_t formatted;
+    formatter_->format(msg, formatted);
+
+    if (canRotate_ && currentSize_ > 0 &&
+        currentSize_ + formatted.size() > maxFileSize_) {
+      file_.close();
+      canRotate_ = rotateFiles();
+      openFile(canRotate_);
+
+      if (!isOpen_) {
+        return;
+      }
+    }
+
+    file_.write(formatted);
+    currentSize_ += formatted.size();
+  }
+
+  void flush_() override {
+    if (isOpen_) {
+      file_.flush();
+    }
+  }
+
+private:
+  void openFile(bool truncate) {
+    try {
+      file_.open(filename_, truncate);
+      currentSize_ = file_.size();
+      isOpen_ = true;
+    } catch (const spdlog::spdlog_ex&) {
+      // The file can't be opened, so drop messages instead of retrying.
+      isOpen_ = false;
+    }
+  }
+
+  std::filesystem::path getRotatedPath(size_t index) const {
+    std::filesystem::path path =
+        spdlog::sinks::rotating_file_sink_st::calc_filename(filename_, index);
+    path += ".gz";
+    return path;
+  }
+
+  // Compresses the log file into the newest rotated file, after moving the
+  // other rotated files along and deleting the oldest. Returns false if the
+  // log file couldn't be rotated, in which case it's left as it was.
+  bool rotateFiles() const {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(filename_, ec);
+    if (ec) {
+      // There's nothing to rotate if there's no log file yet.
+      return !std::filesystem::exists(filename_, ec);
+    }
+
+    // If no rotated files are kept, the log file is just truncated.
+    if (size == 0 || maxRotatedFiles_ == 0) {
+      return true;
+    }
+
+    std::filesystem::remove(getRotatedPath(maxRotatedFiles_), ec);
+    for (auto i = maxRotatedFiles_; i > 1; --i) {
+      auto source = getRotatedPath(i - 1);
+      if (!std::filesystem::exists(source, ec)) {
+        continue;
+      }
+
+      std::filesystem::rename(source, getRotatedPath(i), ec);
+      if (ec) {
+        return false;
+      }
+    }
+
+    return compressFile(filename_, getRotatedPath(1));
+  }
+
+  static bool compressFile(const std::filesystem::path& source,
+                           const std::filesystem::path& target) {
+    std::ifstream in(source, std::ios::binary);
+    if (!in.is_open()) {
+      return false;
+    }
+
+#ifdef _WIN32
+    auto out = gzopen_w(target.c_str(), "wb");
+#else
+    auto out = gzopen(target.c_str(), "wb");
+#endif
+    if (out == nullptr) {
+      return false;
+    }
+
+    std::vector<char> buffer(COMPRESSION_BUFFER_SIZE);
+    bool succeeded = true;
+    while (succeeded && in) {
+      in.read(buffer.data(), buffer.size());
+      auto count = static_cast<unsigned int>(in.gcount());
+      if (count > 0) {
+        succeeded = gzwrite(out, buffer.data(), count) == int(count);
+      }
+    }
+    succeeded = gzclose(out) == Z_OK && succeeded && in.eof();
+
+    if (!succeeded) {
+      std::error_code ec;
+      std::filesystem::remove(target, ec);
+    }
+
+    return succeeded;
+  }
+
+  static constexpr size_t COMPRESSION_BUFFER_SIZE = 64 * 1024;
+
+  const spdlog::filename_t filename_;
+  const size_t maxFileSize_;
+  const size_t maxRotatedFiles_;
+  spdlog::details::file_helper file_;
+  size_t currentSize_ = 0;
+  bool fileOpened_ = false;
+  bool isOpen_ = false;
+  bool canRotate_ = false;
+};
 
 std::shared_ptr<spdlog::logger> getLogger() {
   auto logger = spdlog::get(LOGGER_NAME);
@@ -50,22 +213,49 @@ std::shared_ptr<spdlog::logger> getLogger() {
   return logger;
 }
 
-void setLogPath(const std::filesystem::path& outputFile) {
+void useStderrLogger() {
+  spdlog::set_pattern("[%T.%f] [%l]: %v");
+
+  spdlog::drop(LOGGER_NAME);
+
+  auto logger = spdlog::stderr_logger_mt(LOGGER_NAME);
+  logger->flush_on(spdlog::level::trace);
+}
+
+void setLogPath(const std::filesystem::path& outputFile,
+                const LogFileOptions& options) {
   spdlog::set_pattern("[%T.%f] [%l]: %v");
 
   spdlog::drop(LOGGER_NAME);
+
+  // The thread pool is shared by all async loggers, so only create it once.
+  auto threadPool = spdlog::thread_pool();
+  if (!threadPool) {
+    spdlog::init_thread_pool(LOG_QUEUE_SIZE, 1);
+    threadPool = spdlog::thread_pool();
+  }
+
 #if defined(_WIN32) && defined(SPDLOG_WCHAR_FILENAMES)
-  auto logger = spdlog::basic_logger_mt(LOGGER_NAME,
-                                        outputFile.wstring());
+  auto filename = outputFile.wstring();
 #else
-  auto logger = spdlog::basic_logger_mt(LOGGER_NAME,
-                                        outputFile.u8string());
+  auto filename = outputFile.u8string();
 #endif
+  auto sink = std::make_shared<DeferredRotatingFileSink>(
+      filename, options.maxFileSize, options.maxRotatedFiles);
+
+  auto policy = options.overflowPolicy == LogOverflowPolicy::discardOldest
+                    ? spdlog::async_overflow_policy::overrun_oldest
+                    : spdlog::async_overflow_policy::block;
+  auto logger = std::make_shared<spdlog::async_logger>(
+      LOGGER_NAME, sink, threadPool, policy);
 
   if (!logger) {
     throw std::runtime_error("Error: Could not initialise logging.");
   }
-  logger->flush_on(spdlog::level::trace);
+  spdlog::initialize_logger(logger);
+
+  logger->flush_on(spdlog::level::err);
+  spdlog::flush_every(LOG_FLUSH_INTERVAL);
 }
 
 void enableDebugLogging(bool enable) {
@@ -78,4 +268,6 @@ void enableDebugLogging(bool enable) {
     }
   }
 }
+
+void shutdownLogging() { spdlog::shutdown(); }
 }
@@ -33,11 +33,43 @@
 #include <spdlog/spdlog.h>
 
 namespace loot {
+// What to do when a message is logged while the log's queue of messages that
+// are waiting to be written is full.
+enum class LogOverflowPolicy {
+  // Wait until there is space in the queue, so no messages are lost.
+  block,
+  // Discard the oldest message in the queue to make space.
+  discardOldest,
+};
+
+struct LogFileOptions {
+  LogOverflowPolicy overflowPolicy = LogOverflowPolicy::block;
+  // The size in bytes that the log file can grow to before it is rotated.
+  size_t maxFileSize = 10 * 1024 * 1024;
+  // The number of rotated log files to keep.
+  size_t maxRotatedFiles = 3;
+};
+
 std::shared_ptr<spdlog::logger> getLogger();
 
-void setLogPath(const std::filesystem::path& outputFile);
+// Messages are written to stderr until setLogPath is called, for when stdout
+// is used for output. Otherwise they're written to stdout by default.
+void useStderrLogger();
+
+// Messages are written to the file and flushed in batches on a background
+// thread, except that error and critical messages trigger an immediate flush.
+// Any existing log file is rotated when the first message is written, so that
+// the previous session's log is kept, and again whenever the file grows too
+// large. Rotated files are gzip-compressed on the background thread, and are
+// named like "LOOTDebugLog.1.txt.gz", with higher numbers for older files.
+void setLogPath(const std::filesystem::path& outputFile,
+                const LogFileOptions& options = LogFileOptions());
 
 void enableDebugLogging(bool enable);
+
+// Writes any queued messages and stops the background logging thread. Call
+// before exiting.
+void shutdownLogging();
 }
 
 #endif
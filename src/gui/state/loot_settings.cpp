@@ -226,6 +226,7 @@ LootSettings::LootSettings() :
     enableDebugLogging_(false),
     updateMasterlist_(true),
     enableLootUpdateCheck_(true),
+    inactiveGamesMemoryBudget_(512),
     game_("auto"),
     language_("en"),
     theme_("default"),
@@ -250,6 +251,9 @@ void LootSettings::load(const std::filesystem::path& file,
       settings->get_as<bool>("updateMasterlist").value_or(updateMasterlist_);
   enableLootUpdateCheck_ = settings->get_as<bool>("enableLootUpdateCheck")
                                .value_or(enableLootUpdateCheck_);
+  inactiveGamesMemoryBudget_ =
+      settings->get_as<size_t>("inactiveGamesMemoryBudget")
+          .value_or(inactiveGamesMemoryBudget_);
   game_ = settings->get_as<std::string>("game").value_or(game_);
   language_ = settings->get_as<std::string>("language").value_or(language_);
   theme_ = settings->get_as<std::string>("theme").value_or(theme_);
@@ -320,6 +324,8 @@ void LootSettings::save(const std::filesystem::path& file) {
   root->insert("enableDebugLogging", enableDebugLogging_);
   root->insert("updateMasterlist", updateMasterlist_);
   root->insert("enableLootUpdateCheck", enableLootUpdateCheck_);
+  root->insert("inactiveGamesMemoryBudget",
+               static_cast<int64_t>(inactiveGamesMemoryBudget_));
   root->insert("game", game_);
   root->insert("language", language_);
   root->insert("theme", theme_);
@@ -409,6 +415,12 @@ bool LootSettings::isLootUpdateCheckEnabled() const {
   return enableLootUpdateCheck_;
 }
 
+size_t LootSettings::getInactiveGamesMemoryBudget() const {
+  lock_guard<recursive_mutex> guard(mutex_);
+
+  return inactiveGamesMemoryBudget_;
+}
+
 std::string LootSettings::getGame() const {
   lock_guard<recursive_mutex> guard(mutex_);
 
@@ -507,6 +519,12 @@ void LootSettings::enableLootUpdateCheck(bool enable) {
   enableLootUpdateCheck_ = enable;
 }
 
+void LootSettings::setInactiveGamesMemoryBudget(size_t mebibytes) {
+  lock_guard<recursive_mutex> guard(mutex_);
+
+  inactiveGamesMemoryBudget_ = mebibytes;
+}
+
 void LootSettings::storeLastGame(const std::string& lastGame) {
   lock_guard<recursive_mutex> guard(mutex_);
 
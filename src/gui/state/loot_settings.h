@@ -64,6 +64,8 @@ public:
   bool isDebugLoggingEnabled() const;
   bool updateMasterlist() const;
   bool isLootUpdateCheckEnabled() const;
+  // In MiB.
+  size_t getInactiveGamesMemoryBudget() const;
   std::string getGame() const;
   std::string getLastGame() const;
   std::string getLastVersion() const;
@@ -81,6 +83,7 @@ public:
   void enableDebugLogging(bool enable);
   void updateMasterlist(bool update);
   void enableLootUpdateCheck(bool enable);
+  void setInactiveGamesMemoryBudget(size_t mebibytes);
 
   void storeLastGame(const std::string& lastGame);
   void storeWindowPosition(const WindowPosition& position);
@@ -93,6 +96,7 @@ private:
   bool enableDebugLogging_;
   bool updateMasterlist_;
   bool enableLootUpdateCheck_;
+  size_t inactiveGamesMemoryBudget_;
   std::string game_;
   std::string lastGame_;
   std::string lastVersion_;
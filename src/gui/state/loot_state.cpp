@@ -25,6 +25,8 @@
 
 #include "gui/state/loot_state.h"
 
+#include <algorithm>
+#include <limits>
 #include <unordered_set>
 
 #ifdef _WIN32
@@ -95,8 +97,20 @@ void apiLogCallback(LogLevel level, const char* message) {
   }
 }
 
+static constexpr size_t BYTES_PER_MEBIBYTE = 1024 * 1024;
+
+static size_t mebibytesToBytes(size_t mebibytes) {
+  // Clamp instead of letting an oversized setting wrap around to a tiny one.
+  return std::min(mebibytes,
+                  std::numeric_limits<size_t>::max() / BYTES_PER_MEBIBYTE) *
+         BYTES_PER_MEBIBYTE;
+}
+
 LootState::LootState(const std::filesystem::path& lootAppPath,
                      const std::filesystem::path& lootDataPath) :
+    GamesManager([](const GameSettings& gameSettings) {
+      return gameSettings.FindGamePath();
+    }),
     LootPaths(lootAppPath, lootDataPath) {}
 
 void LootState::init(const std::string& cmdLineGame, bool autoSort) {
@@ -132,8 +146,8 @@ void LootState::init(const std::string& cmdLineGame, bool autoSort) {
     }
   }
 
-  // Initialise logging.
-  fs::remove(LootPaths::getLogPath());
+  // Initialise logging. The previous session's log is rotated instead of
+  // being deleted.
   setLogPath(LootPaths::getLogPath());
   SetLoggingCallback(apiLogCallback);
 
@@ -154,6 +168,9 @@ void LootState::init(const std::string& cmdLineGame, bool autoSort) {
   // Apply debug logging settings.
   enableDebugLogging(isDebugLoggingEnabled());
 
+  SetInactiveGamesMemoryBudget(
+      mebibytesToBytes(getInactiveGamesMemoryBudget()));
+
   // Log some useful info.
   auto logger = getLogger();
   if (logger) {
@@ -228,14 +245,19 @@ void LootState::save(const std::filesystem::path& file) {
   LootSettings::save(file);
 }
 
-std::optional<std::filesystem::path> LootState::FindGamePath(const GameSettings& gameSettings) const {
-  return gameSettings.FindGamePath();
+void LootState::setInactiveGamesMemoryBudget(size_t mebibytes) {
+  LootSettings::setInactiveGamesMemoryBudget(mebibytes);
+  SetInactiveGamesMemoryBudget(mebibytesToBytes(mebibytes));
 }
 
 void LootState::InitialiseGameData(gui::Game& game) {
   game.Init();
 }
 
+size_t LootState::EstimateMemoryUsage(const gui::Game& game) const {
+  return game.EstimateMemoryUsage();
+}
+
 void LootState::SetInitialGame(std::string preferredGame) {
   if (preferredGame.empty()) {
     // Get preferred game from settings.
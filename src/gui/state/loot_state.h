@@ -43,9 +43,12 @@ public:
 
   void storeGameSettings(std::vector<GameSettings> gameSettings);
 
+  // Also applies the new budget, evicting inactive games that no longer fit.
+  void setInactiveGamesMemoryBudget(size_t mebibytes);
+
 private:
-  std::optional<std::filesystem::path> FindGamePath(const GameSettings& gameSettings) const;
   void InitialiseGameData(gui::Game& game);
+  size_t EstimateMemoryUsage(const gui::Game& game) const;
 
   void SetInitialGame(std::string cmdLineGame);
 
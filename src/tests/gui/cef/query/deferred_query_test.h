@@ -0,0 +1,107 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_DEFERRED_QUERY_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_DEFERRED_QUERY_TEST
+
+#include <gtest/gtest.h>
+
+#include "gui/cef/query/deferred_query.h"
+
+namespace loot {
+namespace test {
+class PartialResponseQuery : public Query {
+public:
+  std::string executeLogic() {
+    sendPartialResponse("partial");
+    getCancellationToken().ThrowIfCancelled();
+    return "final";
+  }
+
+  std::optional<std::string> getErrorMessage() { return "error"; }
+};
+
+TEST(DeferredQuery, shouldNotCreateTheWrappedQueryUntilItIsExecuted) {
+  int createCount = 0;
+  DeferredQuery query(QueryAccess::read, [&]() {
+    ++createCount;
+    return std::make_unique<PartialResponseQuery>();
+  });
+
+  EXPECT_EQ(0, createCount);
+
+  EXPECT_EQ("final", query.executeLogic());
+  EXPECT_EQ(1, createCount);
+}
+
+TEST(DeferredQuery, shouldUseTheGivenAccess) {
+  DeferredQuery query(QueryAccess::read,
+                      []() { return std::make_unique<PartialResponseQuery>(); });
+
+  EXPECT_EQ(QueryAccess::read, query.getAccess());
+}
+
+TEST(DeferredQuery, shouldPassPartialResponsesThrough) {
+  DeferredQuery query(QueryAccess::write,
+                      []() { return std::make_unique<PartialResponseQuery>(); });
+  std::vector<std::string> responses;
+  query.setPartialResponseCallback(
+      [&](std::string response) { responses.push_back(response); });
+
+  query.executeLogic();
+
+  EXPECT_EQ(std::vector<std::string>({"partial"}), responses);
+}
+
+TEST(DeferredQuery, shouldShareItsCancellationTokenWithTheWrappedQuery) {
+  DeferredQuery query(QueryAccess::write,
+                      []() { return std::make_unique<PartialResponseQuery>(); });
+  query.getCancellationToken().Cancel();
+
+  EXPECT_THROW(query.executeLogic(), OperationCancelledError);
+}
+
+TEST(DeferredQuery, getErrorMessageShouldReturnTheWrappedQuerysErrorMessage) {
+  DeferredQuery query(QueryAccess::write,
+                      []() { return std::make_unique<PartialResponseQuery>(); });
+
+  EXPECT_EQ(std::nullopt, query.getErrorMessage());
+
+  query.executeLogic();
+
+  EXPECT_EQ("error", query.getErrorMessage());
+}
+
+TEST(DeferredQuery, executeLogicShouldThrowIfTheWrappedQueryCannotBeCreated) {
+  DeferredQuery query(QueryAccess::write, []() -> std::unique_ptr<Query> {
+    throw std::runtime_error("No current game to get.");
+  });
+
+  EXPECT_THROW(query.executeLogic(), std::runtime_error);
+  EXPECT_EQ(std::nullopt, query.getErrorMessage());
+}
+}
+}
+
+#endif
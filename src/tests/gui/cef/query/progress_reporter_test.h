@@ -0,0 +1,149 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_PROGRESS_REPORTER_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_PROGRESS_REPORTER_TEST
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gui/cef/query/progress_reporter.h"
+
+namespace loot {
+namespace test {
+class ProgressReporterTest : public ::testing::Test {
+protected:
+  ProgressCallback collect() {
+    return [this](const ProgressUpdate& update) { sent_.push_back(update); };
+  }
+
+  std::vector<ProgressUpdate> sent_;
+};
+
+TEST(ProgressUpdate, isPhaseCompleteShouldBeFalseIfThereIsNoTotal) {
+  ProgressUpdate update(ProgressPhase::sortingPlugins, "message");
+
+  EXPECT_FALSE(update.IsPhaseComplete());
+}
+
+TEST(ProgressUpdate, isPhaseCompleteShouldBeTrueIfCurrentEqualsTotal) {
+  EXPECT_FALSE(ProgressUpdate(ProgressPhase::loadingPlugins, "", 1, 2)
+                   .IsPhaseComplete());
+  EXPECT_TRUE(ProgressUpdate(ProgressPhase::loadingPlugins, "", 2, 2)
+                  .IsPhaseComplete());
+}
+
+TEST(ProgressUpdate, toJsonShouldOmitCountsIfTheyAreNotSet) {
+  nlohmann::json json = ProgressUpdate(ProgressPhase::sortingPlugins, "text");
+
+  EXPECT_EQ("sortingPlugins", json.at("phase"));
+  EXPECT_EQ("text", json.at("message"));
+  EXPECT_FALSE(json.contains("current"));
+  EXPECT_FALSE(json.contains("total"));
+}
+
+TEST(ProgressUpdate, toJsonShouldIncludeCountsIfTheyAreSet) {
+  nlohmann::json json =
+      ProgressUpdate(ProgressPhase::evaluatingMetadata, "text", 3, 10);
+
+  EXPECT_EQ("evaluatingMetadata", json.at("phase"));
+  EXPECT_EQ("text", json.at("message"));
+  EXPECT_EQ(3, json.at("current"));
+  EXPECT_EQ(10, json.at("total"));
+}
+
+TEST_F(ProgressReporterTest, reportShouldSendTheFirstUpdate) {
+  ProgressReporter reporter(collect(), std::chrono::hours(1));
+
+  reporter.Report(ProgressUpdate(ProgressPhase::loadingPlugins, "a", 1, 10));
+
+  ASSERT_EQ(1, sent_.size());
+  EXPECT_EQ("a", sent_[0].message);
+  EXPECT_EQ(0, reporter.GetDroppedCount());
+}
+
+TEST_F(ProgressReporterTest,
+       reportShouldDropUpdatesMadeWithinTheIntervalOfTheLastSentUpdate) {
+  ProgressReporter reporter(collect(), std::chrono::hours(1));
+
+  reporter.Report(ProgressUpdate(ProgressPhase::loadingPlugins, "a", 1, 10));
+  reporter.Report(ProgressUpdate(ProgressPhase::loadingPlugins, "b", 2, 10));
+  reporter.Report(ProgressUpdate(ProgressPhase::loadingPlugins, "c", 3, 10));
+
+  ASSERT_EQ(1, sent_.size());
+  EXPECT_EQ("a", sent_[0].message);
+  EXPECT_EQ(2, reporter.GetDroppedCount());
+}
+
+TEST_F(ProgressReporterTest,
+       reportShouldSendUpdatesMadeAfterTheIntervalOfTheLastSentUpdate) {
+  ProgressReporter reporter(collect(), std::chrono::steady_clock::duration(0));
+
+  reporter.Report(ProgressUpdate(ProgressPhase::loadingPlugins, "a", 1, 10));
+  reporter.Report(ProgressUpdate(ProgressPhase::loadingPlugins, "b", 2, 10));
+
+  ASSERT_EQ(2, sent_.size());
+  EXPECT_EQ("b", sent_[1].message);
+}
+
+TEST_F(ProgressReporterTest,
+       reportShouldAlwaysSendAnUpdateThatStartsANewPhase) {
+  ProgressReporter reporter(collect(), std::chrono::hours(1));
+
+  reporter.Report(ProgressUpdate(ProgressPhase::loadingPlugins, "a", 1, 10));
+  reporter.Report(ProgressUpdate(ProgressPhase::sortingPlugins, "b"));
+
+  ASSERT_EQ(2, sent_.size());
+  EXPECT_EQ(ProgressPhase::sortingPlugins, sent_[1].phase);
+}
+
+TEST_F(ProgressReporterTest,
+       reportShouldAlwaysSendAnUpdateThatCompletesAPhase) {
+  ProgressReporter reporter(collect(), std::chrono::hours(1));
+
+  reporter.Report(ProgressUpdate(ProgressPhase::loadingPlugins, "a", 1, 10));
+  reporter.Report(ProgressUpdate(ProgressPhase::loadingPlugins, "b", 5, 10));
+  reporter.Report(ProgressUpdate(ProgressPhase::loadingPlugins, "c", 10, 10));
+
+  ASSERT_EQ(2, sent_.size());
+  EXPECT_EQ("c", sent_[1].message);
+  EXPECT_EQ(1, reporter.GetDroppedCount());
+}
+
+TEST_F(ProgressReporterTest,
+       reportShouldDropAnUpdateThatIsBehindTheLastSentUpdateOfItsPhase) {
+  ProgressReporter reporter(collect(), std::chrono::steady_clock::duration(0));
+
+  reporter.Report(ProgressUpdate(ProgressPhase::loadingPlugins, "a", 10, 10));
+  reporter.Report(ProgressUpdate(ProgressPhase::loadingPlugins, "b", 9, 10));
+
+  ASSERT_EQ(1, sent_.size());
+  EXPECT_EQ("a", sent_[0].message);
+  EXPECT_EQ(1, reporter.GetDroppedCount());
+}
+}
+}
+
+#endif
@@ -0,0 +1,104 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_QUERY_REGISTRY_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_QUERY_REGISTRY_TEST
+
+#include <gtest/gtest.h>
+
+#include "gui/cef/query/query_registry.h"
+
+namespace loot {
+namespace test {
+class EchoQuery : public Query {
+public:
+  EchoQuery(const std::string& text) : text_(text) {}
+
+  std::string executeLogic() { return text_; }
+
+private:
+  const std::string text_;
+};
+
+TEST(QueryRegistry, createQueryShouldReturnNullIfNoQueryHasTheGivenName) {
+  QueryRegistry registry;
+
+  EXPECT_EQ(nullptr,
+            registry.CreateQuery("foo", {}, [](const ProgressUpdate&) {}));
+}
+
+TEST(QueryRegistry, createQueryShouldPassTheRequestToTheNamedFactory) {
+  QueryRegistry registry;
+  registry.Register(
+      "foo", [](const nlohmann::json& request, const ProgressCallback&) {
+        return std::make_unique<EchoQuery>(request.at("text"));
+      });
+  registry.Register("bar",
+                    [](const nlohmann::json&, const ProgressCallback&) {
+                      return std::make_unique<EchoQuery>("bar");
+                    });
+
+  auto query = registry.CreateQuery("foo",
+                                    {{"name", "foo"}, {"text", "hello"}},
+                                    [](const ProgressUpdate&) {});
+
+  ASSERT_NE(nullptr, query);
+  EXPECT_EQ("hello", query->executeLogic());
+}
+
+TEST(QueryRegistry, createQueryShouldPassTheProgressCallbackToTheFactory) {
+  QueryRegistry registry;
+  registry.Register(
+      "foo",
+      [](const nlohmann::json&, const ProgressCallback& sendProgressUpdate) {
+        sendProgressUpdate(
+            ProgressUpdate(ProgressPhase::loadingGameData, "progress"));
+        return std::make_unique<EchoQuery>("");
+      });
+
+  std::string message;
+  registry.CreateQuery("foo", {}, [&](const ProgressUpdate& update) {
+    message = update.message;
+  });
+
+  EXPECT_EQ("progress", message);
+}
+
+TEST(QueryRegistry, getStatsShouldReturnStatsPerQueryName) {
+  QueryRegistry registry;
+
+  registry.Record("foo", {std::chrono::milliseconds(1)});
+  registry.Record("foo", {std::chrono::milliseconds(2)});
+  registry.Record("bar", {std::chrono::milliseconds(3)});
+
+  auto stats = registry.GetStats();
+
+  ASSERT_EQ(2, stats.size());
+  EXPECT_EQ(2, stats.at("foo").executionMilliseconds.GetCount());
+  EXPECT_EQ(1, stats.at("bar").executionMilliseconds.GetCount());
+}
+}
+}
+
+#endif
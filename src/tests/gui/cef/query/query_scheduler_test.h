@@ -0,0 +1,204 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_QUERY_SCHEDULER_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_QUERY_SCHEDULER_TEST
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gui/cef/query/query_scheduler.h"
+
+namespace loot {
+namespace test {
+// Lets tasks wait for each other without risking a test hanging forever.
+class TaskLatch {
+public:
+  TaskLatch(size_t count) : count_(count) {}
+
+  void CountDown() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (count_ > 0) {
+      --count_;
+    }
+    zeroReached_.notify_all();
+  }
+
+  bool WaitForZero() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return zeroReached_.wait_for(
+        lock, std::chrono::seconds(5), [&]() { return count_ == 0; });
+  }
+
+private:
+  size_t count_;
+  std::mutex mutex_;
+  std::condition_variable zeroReached_;
+};
+
+// Records the order in which tasks start and finish.
+class TaskRecorder {
+public:
+  void Record(const std::string& event) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    events_.push_back(event);
+  }
+
+  std::vector<std::string> GetEvents() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return events_;
+  }
+
+private:
+  std::mutex mutex_;
+  std::vector<std::string> events_;
+};
+
+TEST(QueryScheduler, destructorShouldWaitForAllScheduledTasksToRun) {
+  TaskRecorder recorder;
+  {
+    QueryScheduler scheduler(2);
+    scheduler.Schedule(QueryAccess::write, [&]() { recorder.Record("1"); });
+    scheduler.Schedule(QueryAccess::read, [&]() { recorder.Record("2"); });
+    scheduler.Schedule(QueryAccess::unsynchronised,
+                       [&]() { recorder.Record("3"); });
+  }
+
+  EXPECT_EQ(3, recorder.GetEvents().size());
+}
+
+TEST(QueryScheduler, shouldRunUnsynchronisedTasksWhileAWriteIsRunning) {
+  TaskLatch latch(1);
+  bool wasUnblocked = false;
+  {
+    QueryScheduler scheduler(2);
+    scheduler.Schedule(QueryAccess::write,
+                       [&]() { wasUnblocked = latch.WaitForZero(); });
+    scheduler.Schedule(QueryAccess::unsynchronised,
+                       [&]() { latch.CountDown(); });
+  }
+
+  EXPECT_TRUE(wasUnblocked);
+}
+
+TEST(QueryScheduler, shouldRunConsecutiveReadsAlongsideEachOther) {
+  TaskLatch latch(2);
+  bool firstWasUnblocked = false;
+  bool secondWasUnblocked = false;
+  {
+    QueryScheduler scheduler(2);
+    scheduler.Schedule(QueryAccess::read, [&]() {
+      latch.CountDown();
+      firstWasUnblocked = latch.WaitForZero();
+    });
+    scheduler.Schedule(QueryAccess::read, [&]() {
+      latch.CountDown();
+      secondWasUnblocked = latch.WaitForZero();
+    });
+  }
+
+  EXPECT_TRUE(firstWasUnblocked);
+  EXPECT_TRUE(secondWasUnblocked);
+}
+
+TEST(QueryScheduler, shouldRunReadsAndWritesInTheOrderTheyWereScheduled) {
+  TaskRecorder recorder;
+  {
+    QueryScheduler scheduler(4);
+    scheduler.Schedule(QueryAccess::write, [&]() {
+      recorder.Record("write 1 start");
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      recorder.Record("write 1 end");
+    });
+    scheduler.Schedule(QueryAccess::read, [&]() {
+      recorder.Record("read start");
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      recorder.Record("read end");
+    });
+    scheduler.Schedule(QueryAccess::write, [&]() {
+      recorder.Record("write 2 start");
+      recorder.Record("write 2 end");
+    });
+  }
+
+  std::vector<std::string> expectedEvents({
+      "write 1 start",
+      "write 1 end",
+      "read start",
+      "read end",
+      "write 2 start",
+      "write 2 end",
+  });
+  EXPECT_EQ(expectedEvents, recorder.GetEvents());
+}
+
+TEST(QueryScheduler, shouldNotLetUnsynchronisedTasksReorderWrites) {
+  TaskRecorder recorder;
+  {
+    QueryScheduler scheduler(4);
+    for (int i = 0; i < 10; ++i) {
+      scheduler.Schedule(QueryAccess::write,
+                         [&, i]() { recorder.Record(std::to_string(i)); });
+      scheduler.Schedule(QueryAccess::unsynchronised, []() {});
+    }
+  }
+
+  std::vector<std::string> expectedEvents;
+  for (int i = 0; i < 10; ++i) {
+    expectedEvents.push_back(std::to_string(i));
+  }
+  EXPECT_EQ(expectedEvents, recorder.GetEvents());
+}
+
+TEST(QueryScheduler, shouldKeepRunningTasksAfterATaskThrows) {
+  TaskRecorder recorder;
+  {
+    QueryScheduler scheduler(1);
+    scheduler.Schedule(QueryAccess::write,
+                       []() { throw std::runtime_error("error"); });
+    scheduler.Schedule(QueryAccess::write, [&]() { recorder.Record("1"); });
+  }
+
+  EXPECT_EQ(std::vector<std::string>({"1"}), recorder.GetEvents());
+}
+
+TEST(QueryScheduler, shouldKeepRunningTasksAfterATaskThrowsANonException) {
+  TaskRecorder recorder;
+  {
+    QueryScheduler scheduler(1);
+    scheduler.Schedule(QueryAccess::write, []() { throw 1; });
+    scheduler.Schedule(QueryAccess::write, [&]() { recorder.Record("1"); });
+  }
+
+  EXPECT_EQ(std::vector<std::string>({"1"}), recorder.GetEvents());
+}
+}
+}
+
+#endif
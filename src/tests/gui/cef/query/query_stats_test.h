@@ -0,0 +1,121 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_QUERY_STATS_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_QUERY_STATS_TEST
+
+#include <gtest/gtest.h>
+
+#include "gui/cef/query/query_stats.h"
+
+namespace loot {
+namespace test {
+TEST(MeasurementSeries, shouldReturnZeroesIfThereAreNoMeasurements) {
+  MeasurementSeries series;
+
+  EXPECT_EQ(0, series.GetCount());
+  EXPECT_EQ(0, series.GetMin());
+  EXPECT_EQ(0, series.GetMedian());
+  EXPECT_EQ(0, series.GetPercentile(99));
+}
+
+TEST(MeasurementSeries, shouldSummariseAddedMeasurements) {
+  MeasurementSeries series;
+
+  for (int i = 100; i > 0; --i) {
+    series.Add(i);
+  }
+
+  EXPECT_EQ(100, series.GetCount());
+  EXPECT_EQ(1, series.GetMin());
+  EXPECT_EQ(50, series.GetMedian());
+  EXPECT_EQ(99, series.GetPercentile(99));
+  EXPECT_EQ(100, series.GetPercentile(100));
+}
+
+TEST(MeasurementSeries, percentilesShouldOnlyUseTheMostRecentMeasurements) {
+  MeasurementSeries series;
+
+  for (size_t i = 0; i < MeasurementSeries::MAX_RETAINED_COUNT; ++i) {
+    series.Add(1000);
+  }
+  for (size_t i = 0; i < MeasurementSeries::MAX_RETAINED_COUNT; ++i) {
+    series.Add(1);
+  }
+
+  EXPECT_EQ(2 * MeasurementSeries::MAX_RETAINED_COUNT, series.GetCount());
+  EXPECT_EQ(1, series.GetMin());
+  EXPECT_EQ(1, series.GetPercentile(100));
+}
+
+TEST(QueryLatencyHistogram, shouldHaveNoCountsByDefault) {
+  QueryLatencyHistogram histogram;
+
+  EXPECT_EQ(0, histogram.GetCount());
+  for (auto bucketCount : histogram.GetBuckets()) {
+    EXPECT_EQ(0, bucketCount);
+  }
+}
+
+TEST(QueryLatencyHistogram,
+     recordShouldCountLatenciesInTheSmallestBucketTheyAreUnder) {
+  QueryLatencyHistogram histogram;
+
+  histogram.Record(std::chrono::microseconds(500));
+  histogram.Record(std::chrono::milliseconds(1));
+  histogram.Record(std::chrono::milliseconds(3));
+  histogram.Record(std::chrono::milliseconds(4));
+
+  EXPECT_EQ(4, histogram.GetCount());
+  EXPECT_EQ(1, histogram.GetBuckets()[0]);
+  EXPECT_EQ(1, histogram.GetBuckets()[1]);
+  EXPECT_EQ(1, histogram.GetBuckets()[2]);
+  EXPECT_EQ(1, histogram.GetBuckets()[3]);
+}
+
+TEST(QueryLatencyHistogram,
+     recordShouldCountLatenciesLongerThanAllBoundsInTheLastBucket) {
+  QueryLatencyHistogram histogram;
+
+  histogram.Record(std::chrono::hours(1));
+
+  EXPECT_EQ(1, histogram.GetBuckets().back());
+}
+
+TEST(QueryStats, recordShouldAddToEachSeriesAndTheHistogram) {
+  QueryStats stats;
+
+  stats.Record(
+      {std::chrono::milliseconds(2), std::chrono::milliseconds(5), 10});
+
+  EXPECT_EQ(2, stats.queueWaitMilliseconds.GetMin());
+  EXPECT_EQ(5, stats.executionMilliseconds.GetMin());
+  EXPECT_EQ(10, stats.responseBytes.GetMin());
+  EXPECT_EQ(1, stats.executionHistogram.GetCount());
+  EXPECT_EQ(1, stats.executionHistogram.GetBuckets()[3]);
+}
+}
+}
+
+#endif
@@ -29,48 +29,10 @@ along with LOOT.  If not, see
 
 #include <gtest/gtest.h>
 
+#include "tests/gui/test_helpers.h"
+
 namespace loot {
 namespace test {
-class TestPlugin : public PluginInterface {
-public:
-  TestPlugin(std::string name) : name_(name) {}
-
-  std::string GetName() const override { return name_; }
-
-  float GetHeaderVersion() const { return 0.0f; }
-
-  std::optional<std::string> GetVersion() const {
-    return std::optional<std::string>();
-  }
-
-  std::vector<std::string> GetMasters() const {
-    return std::vector<std::string>();
-  }
-
-  std::vector<Tag> GetBashTags() const { return std::vector<Tag>(); }
-
-  std::optional<uint32_t> GetCRC() const { return std::optional<uint32_t>(); }
-
-  bool IsMaster() const { return false; }
-
-  bool IsLightMaster() const { return false; }
-
-  bool IsLightPlugin() const { return false; }
-
-  bool IsValidAsLightMaster() const { return false; }
-
-  bool IsValidAsLightPlugin() const { return false; }
-
-  bool IsEmpty() const { return false; }
-
-  bool LoadsArchive() const { return false; }
-
-  bool DoFormIDsOverlap(const PluginInterface& plugin) const { return false; }
-
-private:
-  const std::string name_;
-};
-
 class TestGame {
 public:
   std::shared_ptr<const PluginInterface> GetPlugin(
@@ -120,6 +82,14 @@ public:
     return {};
   }
 
+  std::vector<Message> CheckInstallValidity(
+      std::shared_ptr<const PluginInterface> file,
+      PluginMetadata metadata,
+      const DataDirectoryIndex& dataDirectoryIndex,
+      ConditionCache& conditionCache) {
+    return {};
+  }
+
   void ClearUserMetadata(std::string name) { userMetadata = std::nullopt; }
   void AddUserMetadata(PluginMetadata metadata) { userMetadata = metadata; }
   void SaveUserMetadata() {}
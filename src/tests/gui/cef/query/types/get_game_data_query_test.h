@@ -0,0 +1,602 @@
+/*  LOOT
+
+A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+Fallout: New Vegas.
+
+Copyright (C) 2021    Oliver Hamlet
+
+This file is part of LOOT.
+
+LOOT is free software: you can redistribute
+it and/or modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation, either version 3 of
+the License, or (at your option) any later version.
+
+LOOT is distributed in the hope that it will
+be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with LOOT.  If not, see
+<https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_TYPES_GET_GAME_DATA_QUERY_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_TYPES_GET_GAME_DATA_QUERY_TEST
+
+#include "gui/cef/query/types/get_game_data_query.h"
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+
+#include <gtest/gtest.h>
+
+#include "gui/state/game/metadata_paths.h"
+#include "tests/gui/test_helpers.h"
+
+namespace loot {
+namespace test {
+// A game with a number of installed plugins, where every other plugin is
+// active. It records how often the load order is copied out of it.
+class GameDataTestGame {
+public:
+  GameDataTestGame(size_t pluginCount) :
+      loadOrderCopyCount_(0),
+      activeStateCheckCount_(0),
+      indexedValidityCheckCount_(0),
+      mainMasterCheckCount_(0),
+      metadataLoadCount_(0),
+      metadataListsChanged_(true),
+      backgroundFullLoadStarted_(false) {
+    for (size_t i = 0; i < pluginCount; ++i) {
+      auto pluginName = "Plugin" + std::to_string(i) + ".esp";
+      loadOrder_.push_back(pluginName);
+      plugins_.emplace(pluginName, std::make_shared<TestPlugin>(pluginName));
+    }
+  }
+
+  std::vector<std::shared_ptr<const PluginInterface>> GetPlugins() const {
+    std::vector<std::shared_ptr<const PluginInterface>> plugins;
+    for (const auto& pluginName : loadOrder_) {
+      plugins.push_back(GetPlugin(pluginName));
+    }
+    return plugins;
+  }
+
+  std::shared_ptr<const PluginInterface> GetPlugin(
+      const std::string& name) const {
+    auto it = plugins_.find(name);
+    return it == plugins_.end() ? nullptr : it->second;
+  }
+
+  // Simulates the plugin's file being changed and reloaded.
+  void ReloadPlugin(const std::string& name) {
+    plugins_[name] = std::make_shared<TestPlugin>(name);
+  }
+
+  void LoadAllInstalledPlugins(bool headersOnly,
+                               const CancellationToken& cancellationToken) {}
+  void LoadMetadata() {
+    ++metadataLoadCount_;
+    metadataListsChanged_ = false;
+  }
+  bool HaveMetadataListsChanged() const { return metadataListsChanged_; }
+  void StartBackgroundFullLoad() { backgroundFullLoadStarted_ = true; }
+
+  std::vector<std::string> GetLoadOrder() const {
+    ++loadOrderCopyCount_;
+    return loadOrder_;
+  }
+
+  bool IsPluginActive(const std::string& pluginName) const {
+    ++activeStateCheckCount_;
+    auto it = std::find(loadOrder_.begin(), loadOrder_.end(), pluginName);
+    return std::distance(loadOrder_.begin(), it) % 2 == 0;
+  }
+
+  LoadOrderIndexTable GetActiveLoadOrderIndices(
+      const std::vector<std::string>& loadOrder) const {
+    LoadOrderIndexTable indices;
+    for (const auto& pluginName : loadOrder) {
+      if (IsPluginActive(pluginName)) {
+        indices.AddActivePlugin(pluginName, false);
+      }
+    }
+    return indices;
+  }
+
+  std::string FolderName() const { return "folder"; }
+  std::filesystem::path MasterlistPath() const { return "masterlist.yaml"; }
+  MasterlistInfo GetMasterlistInfo() const { return MasterlistInfo(); }
+  std::vector<Message> GetMessages() const { return {}; }
+  std::vector<std::string> GetKnownBashTags() const { return {}; }
+  std::vector<Group> GetMasterlistGroups() const { return {}; }
+  std::vector<Group> GetUserGroups() const { return {}; }
+
+  std::optional<PluginMetadata> GetMasterlistMetadata(std::string name,
+                                                      bool eval = false) const {
+    auto it = masterlistMetadata_.find(name);
+    if (it == masterlistMetadata_.end()) {
+      return std::nullopt;
+    }
+
+    return it->second;
+  }
+
+  void SetMasterlistMetadata(const PluginMetadata& metadata) {
+    masterlistMetadata_.insert_or_assign(metadata.GetName(), metadata);
+  }
+
+  std::optional<PluginMetadata> GetUserMetadata(std::string name,
+                                                bool eval = false) const {
+    return std::nullopt;
+  }
+
+  std::vector<Message> CheckInstallValidity(
+      std::shared_ptr<const PluginInterface> file,
+      PluginMetadata metadata) {
+    return {};
+  }
+
+  std::vector<Message> CheckInstallValidity(
+      std::shared_ptr<const PluginInterface> file,
+      PluginMetadata metadata,
+      const DataDirectoryIndex& dataDirectoryIndex,
+      ConditionCache& conditionCache) {
+    ++indexedValidityCheckCount_;
+    // Every plugin checks that the main master file is installed.
+    conditionCache.Evaluate(ConditionCache::Function::file, "Main.esm", [&]() {
+      ++mainMasterCheckCount_;
+      return true;
+    });
+    return {};
+  }
+
+  std::shared_ptr<const DataDirectoryIndex> IndexDataDirectory() const {
+    return std::make_shared<DataDirectoryIndex>("");
+  }
+
+  DerivedMetadataCache& GetDerivedMetadataCache() const {
+    return derivedMetadataCache_;
+  }
+
+  std::shared_ptr<const MetadataPaths> GetMetadataPaths() const {
+    std::vector<PluginMetadata> metadata;
+    for (const auto& [name, pluginMetadata] : masterlistMetadata_) {
+      metadata.push_back(pluginMetadata);
+    }
+    return std::make_shared<MetadataPaths>(
+        FindMetadataPaths(GetPlugins(), metadata));
+  }
+
+  size_t GetLoadOrderCopyCount() const { return loadOrderCopyCount_; }
+
+  size_t GetActiveStateCheckCount() const { return activeStateCheckCount_; }
+
+  size_t GetIndexedValidityCheckCount() const {
+    return indexedValidityCheckCount_;
+  }
+
+  bool WasBackgroundFullLoadStarted() const {
+    return backgroundFullLoadStarted_;
+  }
+
+  size_t GetMetadataLoadCount() const { return metadataLoadCount_; }
+
+  size_t GetMainMasterCheckCount() const { return mainMasterCheckCount_; }
+
+  // Simulates the metadata lists being edited outside of LOOT.
+  void ChangeMetadataLists() { metadataListsChanged_ = true; }
+
+private:
+  std::vector<std::string> loadOrder_;
+  std::unordered_map<std::string, std::shared_ptr<const PluginInterface>>
+      plugins_;
+  std::unordered_map<std::string, PluginMetadata> masterlistMetadata_;
+  mutable DerivedMetadataCache derivedMetadataCache_;
+  mutable size_t loadOrderCopyCount_;
+  mutable std::atomic<size_t> activeStateCheckCount_;
+  std::atomic<size_t> indexedValidityCheckCount_;
+  std::atomic<size_t> mainMasterCheckCount_;
+  size_t metadataLoadCount_;
+  bool metadataListsChanged_;
+  bool backgroundFullLoadStarted_;
+};
+
+TEST(GetGameDataQuery, shouldOnlyCopyTheLoadOrderOncePerQuery) {
+  GameDataTestGame game(100);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 0, [](const ProgressUpdate&) {});
+
+  query.executeLogic();
+
+  EXPECT_EQ(1, game.GetLoadOrderCopyCount());
+}
+
+TEST(GetGameDataQuery,
+     shouldCheckEachPluginsActiveStateOnceNoMatterHowManyPluginsThereAre) {
+  for (size_t pluginCount : {10, 100, 1000}) {
+    GameDataTestGame game(pluginCount);
+    GetGameDataQuery<GameDataTestGame> query(
+        game, "en", 0, [](const ProgressUpdate&) {});
+
+    query.executeLogic();
+
+    EXPECT_EQ(pluginCount, game.GetActiveStateCheckCount());
+  }
+}
+
+TEST(GetGameDataQuery, shouldCheckInstallValidityUsingADataDirectoryIndex) {
+  GameDataTestGame game(100);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 0, [](const ProgressUpdate&) {});
+
+  query.executeLogic();
+
+  EXPECT_EQ(100, game.GetIndexedValidityCheckCount());
+}
+
+TEST(GetGameDataQuery, shouldShareConditionResultsBetweenPluginsInAQuery) {
+  GameDataTestGame game(100);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 0, [](const ProgressUpdate&) {});
+
+  query.executeLogic();
+
+  EXPECT_EQ(1, game.GetMainMasterCheckCount());
+}
+
+TEST(GetGameDataQuery, shouldNotShareConditionResultsBetweenQueries) {
+  GameDataTestGame game(10);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 0, [](const ProgressUpdate&) {});
+  GetGameDataQuery<GameDataTestGame> otherQuery(
+      game, "de", 0, [](const ProgressUpdate&) {});
+
+  query.executeLogic();
+  otherQuery.executeLogic();
+
+  EXPECT_EQ(2, game.GetMainMasterCheckCount());
+}
+
+TEST(GetGameDataQuery, shouldStartFullyLoadingPluginsInTheBackground) {
+  GameDataTestGame game(10);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 0, [](const ProgressUpdate&) {});
+
+  query.executeLogic();
+
+  EXPECT_TRUE(game.WasBackgroundFullLoadStarted());
+}
+
+TEST(GetGameDataQuery, shouldOnlyLoadMetadataListsIfTheyHaveChanged) {
+  GameDataTestGame game(10);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 0, [](const ProgressUpdate&) {});
+
+  query.executeLogic();
+  query.executeLogic();
+
+  EXPECT_EQ(1, game.GetMetadataLoadCount());
+
+  game.ChangeMetadataLists();
+  query.executeLogic();
+
+  EXPECT_EQ(2, game.GetMetadataLoadCount());
+}
+
+TEST(GetGameDataQuery, shouldThrowIfCancelledBeforeSerialisingPlugins) {
+  GameDataTestGame game(10);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 0, [](const ProgressUpdate&) {});
+  query.getCancellationToken().Cancel();
+
+  EXPECT_THROW(query.executeLogic(), OperationCancelledError);
+  EXPECT_EQ(0, game.GetIndexedValidityCheckCount());
+}
+
+TEST(GetGameDataQuery, shouldOutputPluginsInLoadOrderWithActiveIndices) {
+  GameDataTestGame game(5);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 0, [](const ProgressUpdate&) {});
+
+  auto json = nlohmann::json::parse(query.executeLogic());
+  auto plugins = json.at("plugins");
+
+  ASSERT_EQ(5, plugins.size());
+  for (size_t i = 0; i < plugins.size(); ++i) {
+    EXPECT_EQ("Plugin" + std::to_string(i) + ".esp",
+              plugins[i].at("name").get<std::string>());
+    EXPECT_EQ(i % 2 == 0, plugins[i].at("isActive").get<bool>());
+  }
+
+  EXPECT_EQ(0, plugins[0].at("loadOrderIndex").get<short>());
+  EXPECT_EQ(0, plugins[1].count("loadOrderIndex"));
+  EXPECT_EQ(1, plugins[2].at("loadOrderIndex").get<short>());
+  EXPECT_EQ(2, plugins[4].at("loadOrderIndex").get<short>());
+}
+
+TEST(GetGameDataQuery, shouldOutputValidJsonIfThereAreNoPlugins) {
+  GameDataTestGame game(0);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 0, [](const ProgressUpdate&) {});
+
+  auto json = nlohmann::json::parse(query.executeLogic());
+
+  EXPECT_EQ(nlohmann::json::array(), json.at("plugins"));
+}
+
+TEST(GetGameDataQuery, shouldOutputGameDataAlongsideThePlugins) {
+  GameDataTestGame game(2);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 0, [](const ProgressUpdate&) {});
+
+  auto json = nlohmann::json::parse(query.executeLogic());
+
+  EXPECT_EQ("folder", json.at("folder"));
+  EXPECT_EQ(nlohmann::json::array(), json.at("generalMessages"));
+  EXPECT_EQ(nlohmann::json::array(), json.at("bashTags"));
+  EXPECT_EQ(1, json.count("masterlist"));
+  EXPECT_EQ(1, json.count("groups"));
+  EXPECT_EQ(2, json.at("plugins").size());
+}
+
+TEST(GetGameDataQuery,
+     shouldOutputPluginsInLoadOrderWhenThereAreEnoughToUseManyThreads) {
+  GameDataTestGame game(1000);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 0, [](const ProgressUpdate&) {});
+
+  auto json = nlohmann::json::parse(query.executeLogic());
+  auto plugins = json.at("plugins");
+
+  ASSERT_EQ(1000, plugins.size());
+  for (size_t i = 0; i < plugins.size(); ++i) {
+    EXPECT_EQ("Plugin" + std::to_string(i) + ".esp",
+              plugins[i].at("name").get<std::string>());
+  }
+}
+
+TEST(GetGameDataQuery, shouldReportProgressEvaluatingEachPluginsMetadata) {
+  GameDataTestGame game(1000);
+  std::mutex mutex;
+  std::vector<ProgressUpdate> updates;
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 0, [&](const ProgressUpdate& update) {
+        std::lock_guard<std::mutex> guard(mutex);
+        updates.push_back(update);
+      });
+
+  query.executeLogic();
+
+  size_t evaluatedCount = 0;
+  for (const auto& update : updates) {
+    if (update.phase == ProgressPhase::evaluatingMetadata) {
+      EXPECT_EQ(1000, update.total.value());
+      evaluatedCount = std::max(evaluatedCount, update.current.value());
+    }
+  }
+
+  EXPECT_EQ(ProgressPhase::loadingGameData, updates.front().phase);
+  EXPECT_EQ(1000, evaluatedCount);
+}
+
+TEST(GetGameDataQuery, shouldReuseCachedMetadataForUnchangedPlugins) {
+  GameDataTestGame game(10);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 0, [](const ProgressUpdate&) {});
+  GetGameDataQuery<GameDataTestGame> otherQuery(
+      game, "en", 0, [](const ProgressUpdate&) {});
+
+  auto json = query.executeLogic();
+  auto otherJson = otherQuery.executeLogic();
+
+  EXPECT_EQ(json, otherJson);
+  EXPECT_EQ(10, game.GetIndexedValidityCheckCount());
+  EXPECT_EQ(10, game.GetDerivedMetadataCache().GetHitCount());
+}
+
+TEST(GetGameDataQuery, shouldNotReuseCachedMetadataForAChangedPlugin) {
+  GameDataTestGame game(10);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 0, [](const ProgressUpdate&) {});
+  GetGameDataQuery<GameDataTestGame> otherQuery(
+      game, "en", 0, [](const ProgressUpdate&) {});
+
+  query.executeLogic();
+  game.ReloadPlugin("Plugin3.esp");
+  otherQuery.executeLogic();
+
+  EXPECT_EQ(11, game.GetIndexedValidityCheckCount());
+}
+
+TEST(GetGameDataQuery,
+     shouldNotReuseCachedMetadataIfAPluginThatAConditionReadsChanges) {
+  GameDataTestGame game(10);
+  PluginMetadata metadata("Plugin0.esp");
+  metadata.SetMessages({
+      Message(MessageType::say, "text", "version(\"plugin3.esp\", \"1\", ==)"),
+  });
+  game.SetMasterlistMetadata(metadata);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 0, [](const ProgressUpdate&) {});
+  GetGameDataQuery<GameDataTestGame> otherQuery(
+      game, "en", 0, [](const ProgressUpdate&) {});
+
+  query.executeLogic();
+  game.ReloadPlugin("Plugin3.esp");
+  otherQuery.executeLogic();
+
+  EXPECT_EQ(20, game.GetIndexedValidityCheckCount());
+}
+
+TEST(GetGameDataQuery,
+     shouldNotReuseCachedMetadataIfAFileThatAConditionReadsChanges) {
+  // The test game's data directory is the working directory.
+  const std::string filename = "LOOT-get-game-data-query-test.txt";
+  std::ofstream(filename) << "content";
+
+  GameDataTestGame game(10);
+  PluginMetadata metadata("Plugin0.esp");
+  metadata.SetMessages({
+      Message(MessageType::say,
+              "text",
+              "checksum(\"" + filename + "\", DEADBEEF)"),
+  });
+  game.SetMasterlistMetadata(metadata);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 0, [](const ProgressUpdate&) {});
+  GetGameDataQuery<GameDataTestGame> otherQuery(
+      game, "en", 0, [](const ProgressUpdate&) {});
+
+  query.executeLogic();
+  std::ofstream(filename) << "changed content";
+  otherQuery.executeLogic();
+  std::filesystem::remove(filename);
+
+  EXPECT_EQ(20, game.GetIndexedValidityCheckCount());
+}
+
+TEST(GetGameDataQuery, shouldNotReuseCachedMetadataForADifferentLanguage) {
+  GameDataTestGame game(10);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 0, [](const ProgressUpdate&) {});
+  GetGameDataQuery<GameDataTestGame> otherQuery(
+      game, "de", 0, [](const ProgressUpdate&) {});
+
+  query.executeLogic();
+  otherQuery.executeLogic();
+
+  EXPECT_EQ(20, game.GetIndexedValidityCheckCount());
+}
+
+TEST(GetGameDataQuery, shouldNotSendPartialResponsesIfBatchSizeIsZero) {
+  GameDataTestGame game(10);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 0, [](const ProgressUpdate&) {});
+  std::vector<std::string> partialResponses;
+  query.setPartialResponseCallback([&](std::string response) {
+    partialResponses.push_back(response);
+  });
+
+  auto json = nlohmann::json::parse(query.executeLogic());
+
+  EXPECT_TRUE(partialResponses.empty());
+  EXPECT_EQ(10, json.at("plugins").size());
+  EXPECT_EQ(0, json.count("isLastBatch"));
+}
+
+TEST(GetGameDataQuery,
+     shouldReturnAllPluginsAtOnceIfPartialResponsesCannotBeSent) {
+  GameDataTestGame game(10);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 3, [](const ProgressUpdate&) {});
+
+  auto json = nlohmann::json::parse(query.executeLogic());
+
+  EXPECT_EQ(10, json.at("plugins").size());
+  EXPECT_EQ(0, json.count("isLastBatch"));
+}
+
+TEST(GetGameDataQuery, shouldSendPluginsInBatchesInLoadOrder) {
+  GameDataTestGame game(10);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 3, [](const ProgressUpdate&) {});
+  std::vector<nlohmann::json> batches;
+  query.setPartialResponseCallback([&](std::string response) {
+    batches.push_back(nlohmann::json::parse(response));
+  });
+
+  batches.push_back(nlohmann::json::parse(query.executeLogic()));
+
+  ASSERT_EQ(4, batches.size());
+  size_t pluginIndex = 0;
+  for (size_t i = 0; i < batches.size(); ++i) {
+    EXPECT_EQ(i == 3, batches[i].at("isLastBatch").get<bool>());
+    EXPECT_EQ(i == 3 ? 1 : 3, batches[i].at("plugins").size());
+
+    for (const auto& plugin : batches[i].at("plugins")) {
+      EXPECT_EQ("Plugin" + std::to_string(pluginIndex) + ".esp",
+                plugin.at("name").get<std::string>());
+      ++pluginIndex;
+    }
+  }
+}
+
+TEST(GetGameDataQuery,
+     shouldSendPluginsInLoadOrderIfManyBatchesAreSerialisedInParallel) {
+  GameDataTestGame game(1000);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 16, [](const ProgressUpdate&) {});
+  std::vector<nlohmann::json> batches;
+  query.setPartialResponseCallback([&](std::string response) {
+    batches.push_back(nlohmann::json::parse(response));
+  });
+
+  batches.push_back(nlohmann::json::parse(query.executeLogic()));
+
+  ASSERT_EQ(63, batches.size());
+  size_t pluginIndex = 0;
+  for (const auto& batch : batches) {
+    for (const auto& plugin : batch.at("plugins")) {
+      EXPECT_EQ("Plugin" + std::to_string(pluginIndex) + ".esp",
+                plugin.at("name").get<std::string>());
+      ++pluginIndex;
+    }
+  }
+  EXPECT_EQ(1000, pluginIndex);
+}
+
+TEST(GetGameDataQuery, shouldNotSendAnyMoreBatchesOnceCancelled) {
+  GameDataTestGame game(1000);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 16, [](const ProgressUpdate&) {});
+  size_t partialResponseCount = 0;
+  query.setPartialResponseCallback([&](std::string) {
+    ++partialResponseCount;
+    query.getCancellationToken().Cancel();
+  });
+
+  EXPECT_THROW(query.executeLogic(), OperationCancelledError);
+  EXPECT_EQ(1, partialResponseCount);
+}
+
+TEST(GetGameDataQuery, shouldOnlyOutputGameDataInTheFirstBatch) {
+  GameDataTestGame game(4);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 2, [](const ProgressUpdate&) {});
+  std::vector<nlohmann::json> batches;
+  query.setPartialResponseCallback([&](std::string response) {
+    batches.push_back(nlohmann::json::parse(response));
+  });
+
+  batches.push_back(nlohmann::json::parse(query.executeLogic()));
+
+  ASSERT_EQ(2, batches.size());
+  EXPECT_EQ("folder", batches[0].at("folder"));
+  EXPECT_EQ(1, batches[0].count("groups"));
+  EXPECT_EQ(0, batches[1].count("folder"));
+  EXPECT_EQ(0, batches[1].count("groups"));
+}
+
+TEST(GetGameDataQuery, shouldReturnASingleBatchIfThereAreNoPlugins) {
+  GameDataTestGame game(0);
+  GetGameDataQuery<GameDataTestGame> query(
+      game, "en", 2, [](const ProgressUpdate&) {});
+  size_t partialResponseCount = 0;
+  query.setPartialResponseCallback(
+      [&](std::string) { ++partialResponseCount; });
+
+  auto json = nlohmann::json::parse(query.executeLogic());
+
+  EXPECT_EQ(0, partialResponseCount);
+  EXPECT_TRUE(json.at("isLastBatch").get<bool>());
+  EXPECT_EQ("folder", json.at("folder"));
+  EXPECT_EQ(nlohmann::json::array(), json.at("plugins"));
+}
+}
+}
+
+#endif
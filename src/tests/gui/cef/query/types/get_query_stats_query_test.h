@@ -0,0 +1,71 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_TYPES_GET_QUERY_STATS_QUERY_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_TYPES_GET_QUERY_STATS_QUERY_TEST
+
+#include "gui/cef/query/types/get_query_stats_query.h"
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+TEST(GetQueryStatsQuery, shouldOutputAnEmptyArrayIfNoQueriesHaveRun) {
+  QueryRegistry registry;
+  GetQueryStatsQuery query(registry);
+
+  auto json = nlohmann::json::parse(query.executeLogic());
+
+  EXPECT_EQ(nlohmann::json::array(), json.at("queries"));
+}
+
+TEST(GetQueryStatsQuery, shouldOutputASummaryOfEachQueryTypesMeasurements) {
+  QueryRegistry registry;
+  registry.Record(
+      "foo",
+      {std::chrono::milliseconds(1), std::chrono::milliseconds(4), 100});
+  registry.Record(
+      "foo",
+      {std::chrono::milliseconds(3), std::chrono::milliseconds(2), 300});
+  GetQueryStatsQuery query(registry);
+
+  auto json = nlohmann::json::parse(query.executeLogic());
+  auto queries = json.at("queries");
+
+  ASSERT_EQ(1, queries.size());
+  EXPECT_EQ("foo", queries[0].at("name"));
+  EXPECT_EQ(2, queries[0].at("count"));
+  EXPECT_EQ(1.0, queries[0].at("queueWaitMilliseconds").at("min"));
+  EXPECT_EQ(1.0, queries[0].at("queueWaitMilliseconds").at("median"));
+  EXPECT_EQ(3.0, queries[0].at("queueWaitMilliseconds").at("p99"));
+  EXPECT_EQ(2.0, queries[0].at("executionMilliseconds").at("min"));
+  EXPECT_EQ(100.0, queries[0].at("responseBytes").at("min"));
+  EXPECT_EQ(300.0, queries[0].at("responseBytes").at("p99"));
+  EXPECT_EQ(QueryLatencyHistogram::BUCKET_COUNT,
+            queries[0].at("executionHistogram").size());
+}
+}
+}
+
+#endif
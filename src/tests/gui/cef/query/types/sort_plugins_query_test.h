@@ -0,0 +1,135 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_CEF_QUERY_TYPES_SORT_PLUGINS_QUERY_TEST
+#define LOOT_TESTS_GUI_CEF_QUERY_TYPES_SORT_PLUGINS_QUERY_TEST
+
+#include "gui/cef/query/types/sort_plugins_query.h"
+
+#include <gtest/gtest.h>
+
+#include "tests/gui/cef/query/types/get_game_data_query_test.h"
+
+namespace loot {
+namespace test {
+// A game that sorts its plugins into the reverse of their current order.
+class SortTestGame : public GameDataTestGame {
+public:
+  SortTestGame(size_t pluginCount) : GameDataTestGame(pluginCount) {}
+
+  GameType Type() const { return GameType::tes4; }
+  std::filesystem::path PluginsTxtPath() const { return "plugins.txt"; }
+
+  std::vector<std::string> SortPlugins() {
+    auto loadOrder = GetLoadOrder();
+    std::reverse(loadOrder.begin(), loadOrder.end());
+    return loadOrder;
+  }
+
+  void SetLoadOrder(const std::vector<std::string>& loadOrder) {}
+};
+
+class SortPluginsQueryTest : public ::testing::Test {
+protected:
+  SortPluginsQueryTest() : game_(5) {}
+
+  typedef SortPluginsQuery<SortTestGame>::MetadataHashes MetadataHashes;
+
+  nlohmann::json sort(std::optional<MetadataHashes> knownMetadataHashes) {
+    SortPluginsQuery<SortTestGame> query(game_,
+                                         counter_,
+                                         "en",
+                                         knownMetadataHashes,
+                                         [](const ProgressUpdate&) {});
+
+    return nlohmann::json::parse(query.executeLogic());
+  }
+
+  MetadataHashes getMetadataHashes() {
+    auto json = sort(std::nullopt);
+
+    MetadataHashes hashes;
+    for (const auto& plugin : json.at("plugins")) {
+      hashes[plugin.at("name")] = plugin.at("metadataHash");
+    }
+
+    return hashes;
+  }
+
+  SortTestGame game_;
+  UnappliedChangeCounter counter_;
+};
+
+TEST_F(SortPluginsQueryTest,
+       shouldOutputMetadataForAllPluginsIfNoMetadataHashesAreGiven) {
+  auto json = sort(std::nullopt);
+
+  EXPECT_EQ(0, json.count("loadOrder"));
+  ASSERT_EQ(5, json.at("plugins").size());
+  EXPECT_EQ("Plugin4.esp", json.at("plugins")[0].at("name"));
+  EXPECT_EQ(1, json.at("plugins")[0].count("metadataHash"));
+}
+
+TEST_F(SortPluginsQueryTest,
+       shouldOutputTheLoadOrderAndNoPluginsIfAllMetadataHashesMatch) {
+  auto json = sort(getMetadataHashes());
+
+  EXPECT_EQ(nlohmann::json::array(), json.at("plugins"));
+
+  auto loadOrder = json.at("loadOrder");
+  ASSERT_EQ(5, loadOrder.size());
+  for (size_t i = 0; i < loadOrder.size(); ++i) {
+    EXPECT_EQ("Plugin" + std::to_string(4 - i) + ".esp",
+              loadOrder[i].at("name").get<std::string>());
+  }
+
+  EXPECT_EQ(0, loadOrder[0].at("loadOrderIndex"));
+  EXPECT_EQ(0, loadOrder[1].count("loadOrderIndex"));
+  EXPECT_EQ(1, loadOrder[2].at("loadOrderIndex"));
+}
+
+TEST_F(SortPluginsQueryTest,
+       shouldOutputMetadataForPluginsWithMissingOrDifferentMetadataHashes) {
+  auto hashes = getMetadataHashes();
+  hashes.erase("Plugin1.esp");
+  hashes["Plugin3.esp"] += 1;
+
+  auto json = sort(hashes);
+
+  auto plugins = json.at("plugins");
+  ASSERT_EQ(2, plugins.size());
+  EXPECT_EQ("Plugin3.esp", plugins[0].at("name"));
+  EXPECT_EQ("Plugin1.esp", plugins[1].at("name"));
+  EXPECT_EQ(5, json.at("loadOrder").size());
+}
+
+TEST_F(SortPluginsQueryTest, shouldIncrementTheUnappliedChangeCounter) {
+  sort(std::nullopt);
+
+  EXPECT_TRUE(counter_.HasUnappliedChanges());
+}
+}
+}
+
+#endif
@@ -0,0 +1,141 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_HEADLESS_SORT_TEST
+#define LOOT_TESTS_GUI_HEADLESS_SORT_TEST
+
+#include <fstream>
+#include <sstream>
+
+#include "gui/headless_sort.h"
+
+#include <gtest/gtest.h>
+#include <spdlog/sinks/null_sink.h>
+
+#include "gui/state/game/game_settings.h"
+#include "gui/state/logging.h"
+#include "tests/common_game_test_fixture.h"
+
+#undef min
+#undef max
+#include <json.hpp>
+
+namespace loot {
+namespace test {
+class HeadlessSortTest : public CommonGameTestFixture {
+protected:
+  HeadlessSortTest() :
+      gameFolder_(GameSettings(GetParam()).FolderName()),
+      initialLocale_(std::locale()) {}
+
+  void SetUp() {
+    std::ofstream out(lootDataPath / "settings.toml");
+    out << "updateMasterlist = false" << std::endl
+        << "[[games]]" << std::endl
+        << "name = \"Game Name\"" << std::endl
+        << "type = \"" << gameFolder_ << "\"" << std::endl
+        << "folder = \"" << gameFolder_ << "\"" << std::endl
+        << "path = '" << dataPath.parent_path().u8string() << "'" << std::endl
+        << "local_path = '" << localPath.u8string() << "'" << std::endl;
+  }
+
+  void TearDown() {
+    // Release the log file before the test files are deleted, and restore
+    // the null logger and locale that the rest of the tests use.
+    shutdownLogging();
+    spdlog::create<spdlog::sinks::null_sink_st>("loot_logger");
+    std::locale::global(initialLocale_);
+
+    CommonGameTestFixture::TearDown();
+  }
+
+  void writeUserlist(const std::string& content) {
+    std::filesystem::create_directories(lootDataPath / gameFolder_);
+    std::ofstream out(lootDataPath / gameFolder_ / "userlist.yaml");
+    out << content;
+  }
+
+  nlohmann::json runHeadlessSort(const std::string& game, int& exitCode) {
+    std::stringstream out;
+    exitCode = RunHeadlessSort(game, lootDataPath, out);
+
+    return nlohmann::json::parse(out.str());
+  }
+
+  const std::string gameFolder_;
+
+private:
+  const std::locale initialLocale_;
+};
+
+// Pass an empty first argument, as it's a prefix for the test instantation,
+// but we only have the one so no prefix is necessary.
+INSTANTIATE_TEST_CASE_P(, HeadlessSortTest, ::testing::Values(GameType::tes5));
+
+TEST_P(HeadlessSortTest, shouldFailIfNoGameIsGiven) {
+  int exitCode = 0;
+  auto json = runHeadlessSort("", exitCode);
+
+  EXPECT_NE(0, exitCode);
+  EXPECT_FALSE(json["applied"].get<bool>());
+  EXPECT_EQ(1, json["errors"].size());
+  EXPECT_FALSE(json.contains("loadOrder"));
+}
+
+TEST_P(HeadlessSortTest, shouldNotApplyTheSortedLoadOrderIfAPluginHasAnError) {
+  // The initial load order has an active plugin with an inactive master.
+  auto initialLoadOrder = getLoadOrder();
+
+  int exitCode = 0;
+  auto json = runHeadlessSort(gameFolder_, exitCode);
+
+  EXPECT_NE(0, exitCode);
+  EXPECT_FALSE(json["applied"].get<bool>());
+  EXPECT_EQ(1, json["errors"].size());
+  ASSERT_EQ(1, json["pluginErrors"].size());
+  EXPECT_EQ(blankDifferentMasterDependentEsp,
+            json["pluginErrors"][0]["plugin"].get<std::string>());
+  EXPECT_EQ(initialLoadOrder, getLoadOrder());
+}
+
+TEST_P(HeadlessSortTest, shouldApplyTheSortedLoadOrderIfThereAreNoErrors) {
+  // Filter patches aren't checked for inactive masters.
+  writeUserlist("plugins:\n  - name: '" + blankDifferentMasterDependentEsp +
+                "'\n    tag: [ Filter ]\n");
+
+  int exitCode = 1;
+  auto json = runHeadlessSort(gameFolder_, exitCode);
+
+  EXPECT_EQ(0, exitCode);
+  EXPECT_TRUE(json["applied"].get<bool>());
+  EXPECT_TRUE(json["errors"].empty());
+  EXPECT_TRUE(json["pluginErrors"].empty());
+  EXPECT_EQ(gameFolder_, json["game"].get<std::string>());
+  EXPECT_EQ(json["loadOrder"].get<std::vector<std::string>>(), getLoadOrder());
+}
+}
+}
+
+#endif
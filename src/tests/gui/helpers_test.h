@@ -98,6 +98,29 @@ TEST(CompareFilenames, shouldBeCaseInsensitiveAndLocaleInvariant) {
   // Reset locale.
   std::locale::global(boost::locale::generator().generate(""));
 }
+
+TEST(NormalizeFilename, shouldGiveEqualOutputsForFilenamesThatCompareEqual) {
+  EXPECT_EQ(NormalizeFilename("i"), NormalizeFilename("I"));
+  EXPECT_EQ(NormalizeFilename(u8"non\u00C1scii.esp"),
+            NormalizeFilename(u8"non\u00E1scii.esp"));
+  EXPECT_EQ(NormalizeFilename(u8"\u03a1"), NormalizeFilename(u8"\u03c1"));
+
+  EXPECT_NE(NormalizeFilename("i"), NormalizeFilename(u8"\u0130"));
+  EXPECT_NE(NormalizeFilename("i"), NormalizeFilename(u8"\u0131"));
+  EXPECT_NE(NormalizeFilename(u8"\u0130"), NormalizeFilename(u8"\u0131"));
+}
+
+TEST(NormalizeFilename, shouldBeLocaleInvariant) {
+  auto normalized = NormalizeFilename("i");
+
+  std::locale::global(boost::locale::generator().generate("tr_TR.UTF-8"));
+
+  EXPECT_EQ(normalized, NormalizeFilename("i"));
+  EXPECT_EQ(normalized, NormalizeFilename("I"));
+
+  // Reset locale.
+  std::locale::global(boost::locale::generator().generate(""));
+}
 }
 }
 
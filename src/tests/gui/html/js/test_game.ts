@@ -627,6 +627,74 @@ describe('Game', () => {
     });
   });
 
+  describe('#setSortedLoadOrder', () => {
+    let game: Game;
+
+    beforeEach(() => {
+      game = new Game(gameData, l10n);
+      game.plugins = [
+        new Plugin({
+          ...defaultDerivedPluginMetadata,
+          name: 'foo',
+          loadOrderIndex: 0
+        }),
+        new Plugin({
+          ...defaultDerivedPluginMetadata,
+          name: 'bar',
+          loadOrderIndex: 1
+        })
+      ];
+    });
+
+    test('should only update the load order index of unchanged plugins', () => {
+      const [foo, bar] = game.plugins;
+
+      game.setSortedLoadOrder(
+        [
+          { name: 'bar', loadOrderIndex: 0 },
+          { name: 'foo', loadOrderIndex: 1 }
+        ],
+        []
+      );
+
+      expect(game.plugins).toEqual([bar, foo]);
+      expect(game.plugins[0].loadOrderIndex).toBe(0);
+      expect(game.plugins[1].loadOrderIndex).toBe(1);
+    });
+
+    test('should update plugins that have changed metadata', () => {
+      game.setSortedLoadOrder(
+        [{ name: 'bar', loadOrderIndex: 0 }, { name: 'foo' }],
+        [
+          {
+            ...defaultDerivedPluginMetadata,
+            name: 'foo',
+            crc: 0xdeadbeef
+          }
+        ]
+      );
+
+      expect(game.plugins[0].crc).toBe(0);
+      expect(game.plugins[1].crc).toBe(0xdeadbeef);
+      expect(game.plugins[1].loadOrderIndex).toBe(undefined);
+    });
+
+    test('should add new plugins using their metadata', () => {
+      game.setSortedLoadOrder(
+        [{ name: 'foo' }, { name: 'bar' }, { name: 'baz' }],
+        [{ ...defaultDerivedPluginMetadata, name: 'baz' }]
+      );
+
+      expect(game.plugins[2].name).toBe('baz');
+    });
+
+    test('should throw if a new plugin has no metadata', () => {
+      expect(() => {
+        game.setSortedLoadOrder([{ name: 'baz' }], []);
+      }).toThrow(Error);
+    });
+  });
+
   describe('#applySort', () => {
     let game: Game;
 
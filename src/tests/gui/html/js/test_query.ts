@@ -2,7 +2,9 @@ import { mocked } from 'ts-jest/utils';
 import {
   getVersion,
   getInitErrors,
-  getConflictingPlugins
+  getConflictingPlugins,
+  getGameDataInBatches,
+  QueryCancelledError
 } from '../../../../gui/html/js/query';
 
 describe('query()', () => {
@@ -46,3 +48,72 @@ describe('query()', () => {
       expect(error).toEqual(new Error('error message'));
     }));
 });
+
+describe('superseded queries', () => {
+  beforeAll(() => {
+    window.cefQuery = jest
+      .fn()
+      .mockImplementationOnce(() => 1)
+      .mockImplementation(({ onSuccess }: CefQueryParameters) => {
+        onSuccess('{"generalMessages": [], "plugins": []}');
+        return 2;
+      });
+    window.cefQueryCancel = jest.fn();
+  });
+
+  test('should be cancelled when a query that supersedes them is sent', () => {
+    const supersededQuery = getConflictingPlugins('plugin.esp');
+    const supersedingQuery = getConflictingPlugins('other.esp');
+
+    expect(mocked(window.cefQueryCancel).mock.calls).toEqual([[1]]);
+
+    return Promise.all([
+      expect(supersededQuery).rejects.toBeInstanceOf(QueryCancelledError),
+      expect(supersedingQuery).resolves.toBeDefined()
+    ]);
+  });
+});
+
+describe('getGameDataInBatches()', () => {
+  beforeAll(() => {
+    window.cefQuery = jest
+      .fn()
+      .mockImplementation(({ onSuccess }: CefQueryParameters) => {
+        const batches = [
+          {
+            folder: 'folder',
+            plugins: [{ name: 'A.esp' }],
+            isLastBatch: false
+          },
+          { plugins: [{ name: 'B.esp' }], isLastBatch: false },
+          { plugins: [{ name: 'C.esp' }], isLastBatch: true }
+        ];
+        batches.forEach(batch => onSuccess(JSON.stringify(batch)));
+        return 3;
+      });
+  });
+
+  test('should send a persistent query with the given batch size', () =>
+    getGameDataInBatches(2, jest.fn(), jest.fn()).then(() => {
+      const parameters = mocked(window.cefQuery).mock.calls[0][0];
+      expect(parameters.persistent).toBe(true);
+      expect(JSON.parse(parameters.request)).toEqual({
+        name: 'getGameData',
+        batchSize: 2
+      });
+    }));
+
+  test('should pass the first and later batches to separate callbacks', () => {
+    const firstBatches: string[] = [];
+    const laterBatches: string[][] = [];
+
+    return getGameDataInBatches(
+      1,
+      gameData => firstBatches.push(gameData.folder),
+      plugins => laterBatches.push(plugins.map(plugin => plugin.name))
+    ).then(() => {
+      expect(firstBatches).toEqual(['folder']);
+      expect(laterBatches).toEqual([['B.esp'], ['C.esp']]);
+    });
+  });
+});
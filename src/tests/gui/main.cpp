@@ -26,18 +26,36 @@
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/null_sink.h>
 
+#include "tests/gui/cef/query/deferred_query_test.h"
 #include "tests/gui/cef/query/json_test.h"
+#include "tests/gui/cef/query/progress_reporter_test.h"
+#include "tests/gui/cef/query/query_registry_test.h"
+#include "tests/gui/cef/query/query_scheduler_test.h"
+#include "tests/gui/cef/query/query_stats_test.h"
 #include "tests/gui/cef/query/types/close_settings_query_test.h"
 #include "tests/gui/cef/query/types/editor_closed_query_test.h"
+#include "tests/gui/cef/query/types/get_game_data_query_test.h"
+#include "tests/gui/cef/query/types/get_query_stats_query_test.h"
 #include "tests/gui/cef/query/types/get_settings_query_test.h"
 #include "tests/gui/cef/query/types/get_themes_query_test.h"
+#include "tests/gui/cef/query/types/sort_plugins_query_test.h"
+#include "tests/gui/state/cancellation_token_test.h"
+#include "tests/gui/state/game/condition_cache_test.h"
+#include "tests/gui/state/game/data_directory_index_test.h"
+#include "tests/gui/state/game/derived_metadata_cache_test.h"
+#include "tests/gui/state/game/form_id_overlap_cache_test.h"
 #include "tests/gui/state/game/game_settings_test.h"
 #include "tests/gui/state/game/game_test.h"
 #include "tests/gui/state/game/games_manager_test.h"
 #include "tests/gui/state/game/helpers_test.h"
+#include "tests/gui/state/game/load_order_index_table_test.h"
+#include "tests/gui/state/game/metadata_paths_test.h"
+#include "tests/gui/state/game/plugin_cache_test.h"
+#include "tests/gui/state/logging_test.h"
 #include "tests/gui/state/loot_paths_test.h"
 #include "tests/gui/state/loot_settings_test.h"
 #include "tests/gui/state/unapplied_change_counter_test.h"
+#include "tests/gui/headless_sort_test.h"
 #include "tests/gui/helpers_test.h"
 
 int main(int argc, char **argv) {
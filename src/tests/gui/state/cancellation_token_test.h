@@ -0,0 +1,67 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_CANCELLATION_TOKEN_TEST
+#define LOOT_TESTS_GUI_STATE_CANCELLATION_TOKEN_TEST
+
+#include "gui/state/cancellation_token.h"
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+TEST(CancellationToken, shouldNotBeCancelledByDefault) {
+  CancellationToken token;
+
+  EXPECT_FALSE(token.IsCancelled());
+  EXPECT_NO_THROW(token.ThrowIfCancelled());
+}
+
+TEST(CancellationToken, shouldBeCancelledAfterCancelIsCalled) {
+  CancellationToken token;
+  token.Cancel();
+
+  EXPECT_TRUE(token.IsCancelled());
+  EXPECT_THROW(token.ThrowIfCancelled(), OperationCancelledError);
+}
+
+TEST(CancellationToken, copiesShouldShareCancellationState) {
+  CancellationToken token;
+  CancellationToken copy = token;
+  copy.Cancel();
+
+  EXPECT_TRUE(token.IsCancelled());
+}
+
+TEST(CancellationToken, separatelyConstructedTokensShouldBeIndependent) {
+  CancellationToken token;
+  CancellationToken other;
+  other.Cancel();
+
+  EXPECT_FALSE(token.IsCancelled());
+}
+}
+}
+
+#endif
@@ -0,0 +1,118 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_GAME_CONDITION_CACHE_TEST
+#define LOOT_TESTS_GUI_STATE_GAME_CONDITION_CACHE_TEST
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gui/state/game/condition_cache.h"
+
+namespace loot {
+namespace test {
+TEST(ConditionCache, evaluateShouldReturnTheResultOfTheEvaluateFunction) {
+  ConditionCache cache;
+
+  EXPECT_TRUE(cache.Evaluate(
+      ConditionCache::Function::file, "a.esp", []() { return true; }));
+  EXPECT_FALSE(cache.Evaluate(
+      ConditionCache::Function::file, "b.esp", []() { return false; }));
+  EXPECT_EQ(0, cache.GetHitCount());
+  EXPECT_EQ(2, cache.GetMissCount());
+}
+
+TEST(ConditionCache,
+     evaluateShouldReturnTheCachedResultIfTheConditionHasBeenEvaluated) {
+  ConditionCache cache;
+  size_t evaluationCount = 0;
+  auto evaluate = [&]() {
+    ++evaluationCount;
+    return evaluationCount == 1;
+  };
+
+  EXPECT_TRUE(
+      cache.Evaluate(ConditionCache::Function::active, "a.esp", evaluate));
+  EXPECT_TRUE(
+      cache.Evaluate(ConditionCache::Function::active, "a.esp", evaluate));
+  EXPECT_EQ(1, evaluationCount);
+  EXPECT_EQ(1, cache.GetHitCount());
+  EXPECT_EQ(1, cache.GetMissCount());
+}
+
+TEST(ConditionCache, evaluateShouldCacheDifferentFunctionsSeparately) {
+  ConditionCache cache;
+
+  cache.Evaluate(ConditionCache::Function::file, "a.esp", []() {
+    return true;
+  });
+
+  EXPECT_FALSE(cache.Evaluate(
+      ConditionCache::Function::active, "a.esp", []() { return false; }));
+  EXPECT_EQ(0, cache.GetHitCount());
+}
+
+TEST(ConditionCache, evaluateShouldCompareArgumentsCaseSensitively) {
+  ConditionCache cache;
+
+  cache.Evaluate(ConditionCache::Function::file, "a.esp", []() {
+    return true;
+  });
+
+  EXPECT_FALSE(cache.Evaluate(
+      ConditionCache::Function::file, "A.esp", []() { return false; }));
+  EXPECT_EQ(0, cache.GetHitCount());
+}
+
+TEST(ConditionCache, evaluateShouldBeThreadSafe) {
+  ConditionCache cache;
+  static constexpr size_t THREAD_COUNT = 4;
+  static constexpr size_t CONDITION_COUNT = 100;
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < THREAD_COUNT; ++i) {
+    threads.emplace_back([&]() {
+      for (size_t j = 0; j < CONDITION_COUNT; ++j) {
+        auto result = cache.Evaluate(ConditionCache::Function::file,
+                                     std::to_string(j),
+                                     [j]() { return j % 2 == 0; });
+        EXPECT_EQ(j % 2 == 0, result);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(THREAD_COUNT * CONDITION_COUNT,
+            cache.GetHitCount() + cache.GetMissCount());
+  EXPECT_EQ(CONDITION_COUNT, cache.GetMissCount());
+}
+}
+}
+
+#endif
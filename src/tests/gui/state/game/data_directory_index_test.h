@@ -0,0 +1,194 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+#ifndef LOOT_TESTS_GUI_STATE_GAME_DATA_DIRECTORY_INDEX_TEST
+#define LOOT_TESTS_GUI_STATE_GAME_DATA_DIRECTORY_INDEX_TEST
+
+#include "gui/state/game/data_directory_index.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <fstream>
+
+#include "tests/gui/test_helpers.h"
+
+namespace loot {
+namespace test {
+class DataDirectoryIndexTest : public ::testing::Test {
+public:
+  DataDirectoryIndexTest() : dataPath(getTempPath()) {}
+
+protected:
+  void SetUp() override {
+    std::filesystem::create_directories(dataPath / "textures");
+    touch(dataPath / "Blank.esp");
+    touch(dataPath / "Blank.esm.ghost");
+    touch(dataPath / "textures" / "Blank.dds");
+  }
+
+  void TearDown() override { std::filesystem::remove_all(dataPath); }
+
+  const std::filesystem::path dataPath;
+};
+
+TEST_F(DataDirectoryIndexTest, constructorShouldIndexFilesAndDirectories) {
+  DataDirectoryIndex index(dataPath);
+
+  EXPECT_EQ(3, index.GetEntryCount());
+}
+
+TEST_F(DataDirectoryIndexTest, constructorShouldNotThrowIfThePathDoesNotExist) {
+  DataDirectoryIndex index(dataPath / "missing");
+
+  EXPECT_EQ(0, index.GetEntryCount());
+  EXPECT_FALSE(index.Exists("Blank.esp"));
+}
+
+TEST_F(DataDirectoryIndexTest,
+       existsShouldFindIndexedFilesWithoutTheFilesystem) {
+  DataDirectoryIndex index(dataPath);
+
+  EXPECT_TRUE(index.Exists("Blank.esp"));
+  EXPECT_TRUE(index.Exists("Blank.esm.ghost"));
+  EXPECT_TRUE(index.Exists("textures"));
+  EXPECT_FALSE(index.Exists("Blank.esm"));
+
+  EXPECT_EQ(4, index.GetIndexedLookupCount());
+  EXPECT_EQ(0, index.GetFilesystemLookupCount());
+}
+
+TEST_F(DataDirectoryIndexTest, existsShouldBeCaseInsensitive) {
+  DataDirectoryIndex index(dataPath);
+
+  EXPECT_TRUE(index.Exists("blank.esp"));
+  EXPECT_TRUE(index.Exists("BLANK.ESP"));
+}
+
+TEST_F(DataDirectoryIndexTest,
+       existsShouldCheckTheFilesystemForPathsInSubdirectories) {
+  DataDirectoryIndex index(dataPath);
+
+  EXPECT_TRUE(index.Exists("textures/Blank.dds"));
+  EXPECT_FALSE(index.Exists("textures/Missing.dds"));
+  EXPECT_TRUE(index.Exists("../" + dataPath.filename().u8string()));
+
+  EXPECT_EQ(0, index.GetIndexedLookupCount());
+  EXPECT_EQ(3, index.GetFilesystemLookupCount());
+}
+
+TEST_F(DataDirectoryIndexTest, existsShouldNotSeeFilesAddedAfterIndexing) {
+  DataDirectoryIndex index(dataPath);
+
+  touch(dataPath / "Blank - Different.esp");
+
+  EXPECT_FALSE(index.Exists("Blank - Different.esp"));
+  EXPECT_TRUE(DataDirectoryIndex(dataPath).Exists("Blank - Different.esp"));
+}
+
+TEST_F(DataDirectoryIndexTest,
+       fingerprintShouldBeTheSameForIndicesOfTheSameEntries) {
+  EXPECT_EQ(DataDirectoryIndex(dataPath).GetFingerprint(),
+            DataDirectoryIndex(dataPath).GetFingerprint());
+}
+
+TEST_F(DataDirectoryIndexTest, fingerprintShouldChangeIfAnEntryIsAdded) {
+  auto fingerprint = DataDirectoryIndex(dataPath).GetFingerprint();
+
+  touch(dataPath / "Blank - Different.esp");
+
+  EXPECT_NE(fingerprint, DataDirectoryIndex(dataPath).GetFingerprint());
+}
+
+TEST_F(DataDirectoryIndexTest,
+       fileStateFingerprintShouldChangeIfAFileInASubdirectoryChanges) {
+  DataDirectoryIndex index(dataPath);
+  auto fingerprint = index.GetFileStateFingerprint({"textures/Blank.dds"});
+
+  std::ofstream out(dataPath / "textures" / "Blank.dds");
+  out << "content";
+  out.close();
+
+  EXPECT_NE(fingerprint,
+            index.GetFileStateFingerprint({"textures/Blank.dds"}));
+}
+
+TEST_F(DataDirectoryIndexTest,
+       fileStateFingerprintShouldChangeIfAFileMatchingARegexIsAdded) {
+  DataDirectoryIndex index(dataPath);
+  auto fingerprint = index.GetFileStateFingerprint({"textures/.+\\.dds"});
+
+  // Make sure that the directory's modification time changes.
+  std::filesystem::last_write_time(
+      dataPath / "textures",
+      std::filesystem::last_write_time(dataPath / "textures") -
+          std::chrono::hours(1));
+  touch(dataPath / "textures" / "Other.dds");
+
+  EXPECT_NE(fingerprint,
+            index.GetFileStateFingerprint({"textures/.+\\.dds"}));
+}
+
+TEST_F(DataDirectoryIndexTest,
+       fileStateFingerprintShouldBeTheSameIfNoGivenFilesChange) {
+  DataDirectoryIndex index(dataPath);
+  auto fingerprint =
+      index.GetFileStateFingerprint({"textures/Blank.dds", "missing.txt"});
+
+  touch(dataPath / "Blank.esp");
+
+  EXPECT_EQ(fingerprint,
+            index.GetFileStateFingerprint(
+                {"textures/Blank.dds", "missing.txt"}));
+}
+
+TEST_F(DataDirectoryIndexTest,
+       fileStateFingerprintShouldCountEachPathCheckedAsAFilesystemLookup) {
+  DataDirectoryIndex index(dataPath);
+
+  // The paths' parent directories are checked too.
+  index.GetFileStateFingerprint({"textures/Blank.dds", "missing.txt"});
+
+  EXPECT_EQ(4, index.GetFilesystemLookupCount());
+}
+
+TEST_F(DataDirectoryIndexTest,
+       fileStateFingerprintShouldCheckTheParentDirectoryOfBackslashPaths) {
+  DataDirectoryIndex index(dataPath);
+
+  // Both paths have the same parent directory.
+  index.GetFileStateFingerprint({"textures/Blank.dds", "textures\\Blank.esp"});
+
+  EXPECT_EQ(3, index.GetFilesystemLookupCount());
+}
+
+TEST_F(DataDirectoryIndexTest, canIndexShouldOnlyBeTrueForFilenames) {
+  EXPECT_TRUE(DataDirectoryIndex::CanIndex("Blank.esp"));
+  EXPECT_FALSE(DataDirectoryIndex::CanIndex("textures/Blank.dds"));
+  EXPECT_FALSE(DataDirectoryIndex::CanIndex("textures\\Blank.dds"));
+  EXPECT_FALSE(DataDirectoryIndex::CanIndex(".."));
+}
+}
+}
+
+#endif
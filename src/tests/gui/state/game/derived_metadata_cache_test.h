@@ -0,0 +1,196 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_GAME_DERIVED_METADATA_CACHE_TEST
+#define LOOT_TESTS_GUI_STATE_GAME_DERIVED_METADATA_CACHE_TEST
+
+#include "gui/state/game/derived_metadata_cache.h"
+
+#include <gtest/gtest.h>
+
+#include "tests/gui/test_helpers.h"
+
+namespace loot {
+namespace test {
+class DerivedMetadataCacheTest : public ::testing::Test {
+protected:
+  DerivedMetadataCacheTest() :
+      plugin_(std::make_shared<TestPlugin>("Blank.esp")),
+      entry_{"{\"name\":\"Blank.esp\"}", 1} {}
+
+  std::shared_ptr<const PluginInterface> plugin_;
+  DerivedMetadataCache::Entry entry_;
+  DerivedMetadataCache cache_;
+};
+
+TEST_F(DerivedMetadataCacheTest, getShouldReturnNulloptIfThePluginIsNotCached) {
+  EXPECT_FALSE(cache_.Get(plugin_, 0).has_value());
+  EXPECT_EQ(0, cache_.GetHitCount());
+  EXPECT_EQ(1, cache_.GetMissCount());
+}
+
+TEST_F(DerivedMetadataCacheTest,
+       getShouldReturnTheEntryForTheSamePluginAndLoadOrderIndex) {
+  cache_.Set(plugin_, 0, entry_, cache_.GetGeneration());
+
+  auto cached = cache_.Get(plugin_, 0);
+
+  ASSERT_TRUE(cached.has_value());
+  EXPECT_EQ(entry_.json, cached.value().json);
+  EXPECT_EQ(entry_.metadataHash, cached.value().metadataHash);
+  EXPECT_EQ(1, cache_.GetHitCount());
+}
+
+TEST_F(DerivedMetadataCacheTest,
+       getShouldCompareThePluginNameCaseInsensitively) {
+  cache_.Set(plugin_, 0, entry_, cache_.GetGeneration());
+
+  auto otherCase = std::make_shared<TestPlugin>("blank.ESP");
+  cache_.Set(otherCase, 0, entry_, cache_.GetGeneration());
+
+  EXPECT_EQ(1, cache_.Size());
+  EXPECT_FALSE(cache_.Get(plugin_, 0).has_value());
+  EXPECT_TRUE(cache_.Get(otherCase, 0).has_value());
+}
+
+TEST_F(DerivedMetadataCacheTest,
+       getShouldReturnNulloptIfTheLoadOrderIndexIsDifferent) {
+  cache_.Set(plugin_, 0, entry_, cache_.GetGeneration());
+
+  EXPECT_FALSE(cache_.Get(plugin_, 1).has_value());
+  EXPECT_FALSE(cache_.Get(plugin_, std::nullopt).has_value());
+}
+
+TEST_F(DerivedMetadataCacheTest,
+       getShouldReturnNulloptIfThePluginObjectIsDifferent) {
+  cache_.Set(plugin_, 0, entry_, cache_.GetGeneration());
+
+  auto reloadedPlugin = std::make_shared<TestPlugin>("Blank.esp");
+
+  EXPECT_FALSE(cache_.Get(reloadedPlugin, 0).has_value());
+}
+
+TEST_F(DerivedMetadataCacheTest,
+       getShouldReturnTheEntryForAReloadedPluginWithTheSameCrc) {
+  auto plugin = std::make_shared<TestPlugin>("Blank.esp", 1);
+  cache_.Set(plugin, 0, entry_, cache_.GetGeneration());
+
+  auto reloadedPlugin = std::make_shared<TestPlugin>("Blank.esp", 1);
+
+  EXPECT_TRUE(cache_.Get(reloadedPlugin, 0).has_value());
+}
+
+TEST_F(DerivedMetadataCacheTest, getShouldReturnNulloptIfTheCrcIsDifferent) {
+  auto plugin = std::make_shared<TestPlugin>("Blank.esp", 1);
+  cache_.Set(plugin, 0, entry_, cache_.GetGeneration());
+
+  auto changedPlugin = std::make_shared<TestPlugin>("Blank.esp", 2);
+
+  EXPECT_FALSE(cache_.Get(changedPlugin, 0).has_value());
+}
+
+TEST_F(DerivedMetadataCacheTest,
+       getShouldReturnNulloptIfOnlyOneOfThePluginsHasACrc) {
+  auto plugin = std::make_shared<TestPlugin>("Blank.esp", 1);
+  cache_.Set(plugin, 0, entry_, cache_.GetGeneration());
+
+  EXPECT_FALSE(cache_.Get(plugin_, 0).has_value());
+}
+
+TEST_F(DerivedMetadataCacheTest,
+       setShouldNotAddAnEntryDerivedBeforeTheMetadataChanged) {
+  auto generation = cache_.GetGeneration();
+
+  cache_.Invalidate("Blank.esm");
+  cache_.Set(plugin_, 0, entry_, generation);
+
+  EXPECT_EQ(0, cache_.Size());
+}
+
+TEST_F(DerivedMetadataCacheTest, clearShouldStartANewGeneration) {
+  auto generation = cache_.GetGeneration();
+
+  cache_.Clear();
+
+  EXPECT_NE(generation, cache_.GetGeneration());
+}
+
+TEST_F(DerivedMetadataCacheTest, memoryUsageShouldBeZeroIfTheCacheIsEmpty) {
+  EXPECT_EQ(0, cache_.GetMemoryUsage());
+}
+
+TEST_F(DerivedMetadataCacheTest,
+       memoryUsageShouldIncludeTheSizeOfTheSerialisedMetadata) {
+  entry_.json = std::string(1024, ' ');
+  cache_.Set(plugin_, 0, entry_, cache_.GetGeneration());
+
+  EXPECT_LT(1024, cache_.GetMemoryUsage());
+
+  cache_.Clear();
+
+  EXPECT_EQ(0, cache_.GetMemoryUsage());
+}
+
+TEST_F(DerivedMetadataCacheTest, invalidateShouldOnlyRemoveTheGivenPlugin) {
+  auto otherPlugin = std::make_shared<TestPlugin>("Blank.esm");
+  cache_.Set(plugin_, 0, entry_, cache_.GetGeneration());
+  cache_.Set(otherPlugin, 1, entry_, cache_.GetGeneration());
+
+  cache_.Invalidate("blank.esp");
+
+  EXPECT_FALSE(cache_.Get(plugin_, 0).has_value());
+  EXPECT_TRUE(cache_.Get(otherPlugin, 1).has_value());
+}
+
+TEST_F(DerivedMetadataCacheTest, setContextShouldKeepEntriesIfItIsUnchanged) {
+  cache_.SetContext(1);
+  cache_.Set(plugin_, 0, entry_, cache_.GetGeneration());
+
+  cache_.SetContext(1);
+
+  EXPECT_TRUE(cache_.Get(plugin_, 0).has_value());
+}
+
+TEST_F(DerivedMetadataCacheTest, setContextShouldClearTheCacheIfItChanges) {
+  cache_.SetContext(1);
+  cache_.Set(plugin_, 0, entry_, cache_.GetGeneration());
+
+  cache_.SetContext(2);
+
+  EXPECT_EQ(0, cache_.Size());
+}
+
+TEST_F(DerivedMetadataCacheTest, copiesShouldHaveIndependentEntries) {
+  cache_.Set(plugin_, 0, entry_, cache_.GetGeneration());
+
+  DerivedMetadataCache copy(cache_);
+  copy.Clear();
+
+  EXPECT_EQ(1, cache_.Size());
+  EXPECT_EQ(0, copy.Size());
+}
+}
+}
+
+#endif
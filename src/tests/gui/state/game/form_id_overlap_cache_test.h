@@ -0,0 +1,146 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+#ifndef LOOT_TESTS_GUI_STATE_GAME_FORM_ID_OVERLAP_CACHE_TEST
+#define LOOT_TESTS_GUI_STATE_GAME_FORM_ID_OVERLAP_CACHE_TEST
+
+#include "gui/state/game/form_id_overlap_cache.h"
+
+#include <gtest/gtest.h>
+
+#include "tests/gui/test_helpers.h"
+
+namespace loot {
+namespace test {
+// A plugin that overlaps with every other plugin and counts how many times
+// it has been compared with another plugin.
+class OverlappingTestPlugin : public TestPlugin {
+public:
+  OverlappingTestPlugin(std::string name) :
+      TestPlugin(name), comparisonCount_(0) {}
+
+  bool DoFormIDsOverlap(const PluginInterface& plugin) const override {
+    ++comparisonCount_;
+    return true;
+  }
+
+  size_t GetComparisonCount() const { return comparisonCount_; }
+
+private:
+  mutable size_t comparisonCount_;
+};
+
+class FormIdOverlapCacheTest : public ::testing::Test {
+protected:
+  FormIdOverlapCacheTest() :
+      plugin_(std::make_shared<OverlappingTestPlugin>("A.esp")),
+      plugins_({
+          std::make_shared<TestPlugin>("B.esp"),
+          std::make_shared<TestPlugin>("C.esp"),
+      }) {}
+
+  std::shared_ptr<OverlappingTestPlugin> plugin_;
+  std::vector<std::shared_ptr<const PluginInterface>> plugins_;
+};
+
+TEST_F(FormIdOverlapCacheTest,
+       getOverlappingPluginsShouldReturnTheNamesOfOverlappingPlugins) {
+  FormIdOverlapCache cache;
+
+  auto overlappingPlugins = cache.GetOverlappingPlugins(*plugin_, plugins_);
+
+  EXPECT_EQ(FormIdOverlapCache::OverlappingPlugins({
+                NormalizeFilename("B.esp"),
+                NormalizeFilename("C.esp"),
+            }),
+            *overlappingPlugins);
+}
+
+TEST_F(FormIdOverlapCacheTest,
+       getOverlappingPluginsShouldNotIncludePluginsThatDoNotOverlap) {
+  FormIdOverlapCache cache;
+
+  auto overlappingPlugins =
+      cache.GetOverlappingPlugins(TestPlugin("A.esp"), plugins_);
+
+  EXPECT_TRUE(overlappingPlugins->empty());
+}
+
+TEST_F(FormIdOverlapCacheTest,
+       getOverlappingPluginsShouldOnlyCompareAPluginWithOthersOnce) {
+  FormIdOverlapCache cache;
+
+  cache.GetOverlappingPlugins(*plugin_, plugins_);
+  cache.GetOverlappingPlugins(*plugin_, plugins_);
+
+  EXPECT_EQ(plugins_.size(), plugin_->GetComparisonCount());
+  EXPECT_EQ(1, cache.Size());
+}
+
+TEST_F(FormIdOverlapCacheTest,
+       getOverlappingPluginsShouldCaseInsensitivelyMatchNames) {
+  FormIdOverlapCache cache;
+  OverlappingTestPlugin otherCasePlugin("a.ESP");
+
+  cache.GetOverlappingPlugins(*plugin_, plugins_);
+  auto overlappingPlugins = cache.GetOverlappingPlugins(otherCasePlugin, {});
+
+  EXPECT_EQ(2, overlappingPlugins->size());
+  EXPECT_EQ(0, otherCasePlugin.GetComparisonCount());
+}
+
+TEST_F(FormIdOverlapCacheTest,
+       getOverlappingPluginsShouldEvictTheLeastRecentlyUsedResults) {
+  FormIdOverlapCache cache(2);
+  OverlappingTestPlugin otherPlugin("B.esp");
+  OverlappingTestPlugin thirdPlugin("C.esp");
+
+  cache.GetOverlappingPlugins(*plugin_, plugins_);
+  cache.GetOverlappingPlugins(otherPlugin, plugins_);
+  // Use the first plugin's results so that the second plugin's are evicted.
+  cache.GetOverlappingPlugins(*plugin_, plugins_);
+  cache.GetOverlappingPlugins(thirdPlugin, plugins_);
+
+  EXPECT_EQ(2, cache.Size());
+
+  cache.GetOverlappingPlugins(*plugin_, plugins_);
+  cache.GetOverlappingPlugins(otherPlugin, plugins_);
+
+  EXPECT_EQ(plugins_.size(), plugin_->GetComparisonCount());
+  EXPECT_EQ(2 * plugins_.size(), otherPlugin.GetComparisonCount());
+}
+
+TEST_F(FormIdOverlapCacheTest, clearShouldForgetAllResults) {
+  FormIdOverlapCache cache;
+
+  cache.GetOverlappingPlugins(*plugin_, plugins_);
+  cache.Clear();
+  cache.GetOverlappingPlugins(*plugin_, plugins_);
+
+  EXPECT_EQ(2 * plugins_.size(), plugin_->GetComparisonCount());
+  EXPECT_EQ(1, cache.Size());
+}
+}
+}
+
+#endif
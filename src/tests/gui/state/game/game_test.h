@@ -25,6 +25,7 @@ along with LOOT.  If not, see
 #ifndef LOOT_TESTS_GUI_STATE_GAME_GAME_TEST
 #define LOOT_TESTS_GUI_STATE_GAME_GAME_TEST
 
+#include <chrono>
 #include <fstream>
 
 #include "gui/state/game/game.h"
@@ -244,6 +245,56 @@ TEST_P(GameTest,
   EXPECT_TRUE(messages.empty());
 }
 
+TEST_P(GameTest,
+       checkInstallValidityWithADataDirectoryIndexShouldMatchTheFilesystem) {
+  ASSERT_NO_THROW(std::filesystem::rename(dataPath / blankEsp,
+                                          dataPath / (blankEsp + ".ghost")));
+
+  Game game = CreateInitialisedGame("");
+  game.LoadAllInstalledPlugins(true);
+
+  PluginMetadata metadata(blankEsm);
+  metadata.SetRequirements({
+      File(missingEsp),
+      File(blankEsp),
+  });
+
+  auto index = game.IndexDataDirectory();
+  ConditionCache conditionCache;
+  auto plugin = game.GetPlugin(blankEsm);
+
+  EXPECT_EQ(
+      game.CheckInstallValidity(plugin, metadata),
+      game.CheckInstallValidity(plugin, metadata, *index, conditionCache));
+  EXPECT_LT(0, index->GetIndexedLookupCount());
+}
+
+TEST_P(
+    GameTest,
+    checkInstallValidityWithAConditionCacheShouldReuseResultsForOtherPlugins) {
+  Game game = CreateInitialisedGame("");
+  game.LoadAllInstalledPlugins(true);
+
+  PluginMetadata metadata(blankEsm);
+  metadata.SetRequirements({
+      File(missingEsp),
+      File(blankEsp),
+  });
+
+  auto index = game.IndexDataDirectory();
+  ConditionCache conditionCache;
+
+  auto messages = game.CheckInstallValidity(
+      game.GetPlugin(blankEsm), metadata, *index, conditionCache);
+  auto lookupCount = index->GetIndexedLookupCount();
+  auto otherMessages = game.CheckInstallValidity(
+      game.GetPlugin(blankEsm), metadata, *index, conditionCache);
+
+  EXPECT_EQ(messages, otherMessages);
+  EXPECT_EQ(lookupCount, index->GetIndexedLookupCount());
+  EXPECT_LT(0, conditionCache.GetHitCount());
+}
+
 TEST_P(
     GameTest,
     checkInstallValidityShouldUseDisplayNamesInRequirementMessagesIfPresent) {
@@ -613,6 +664,122 @@ TEST_P(GameTest,
             game.GetMessages()[0].GetContent()[0].GetText());
 }
 
+TEST_P(GameTest,
+       loadAllInstalledPluginsShouldNotReloadPluginsIfNoneHaveChanged) {
+  Game game = CreateInitialisedGame("");
+
+  ASSERT_NO_THROW(game.LoadAllInstalledPlugins(true));
+  auto plugin = game.GetPlugin(blankEsm);
+
+  ASSERT_NO_THROW(game.LoadAllInstalledPlugins(true));
+  EXPECT_EQ(plugin, game.GetPlugin(blankEsm));
+}
+
+TEST_P(GameTest,
+       loadAllInstalledPluginsShouldReloadPluginsIfAPluginHasBeenAdded) {
+  Game game = CreateInitialisedGame("");
+
+  ASSERT_NO_THROW(game.LoadAllInstalledPlugins(true));
+  auto plugin = game.GetPlugin(blankEsm);
+
+  std::filesystem::copy_file(dataPath / blankEsp,
+                             dataPath / "Blank - Copy.esp");
+
+  ASSERT_NO_THROW(game.LoadAllInstalledPlugins(true));
+  EXPECT_NE(plugin, game.GetPlugin(blankEsm));
+  EXPECT_EQ(13, game.GetPlugins().size());
+}
+
+TEST_P(GameTest,
+       loadAllInstalledPluginsShouldReloadPluginsIfAPluginHasBeenRemoved) {
+  Game game = CreateInitialisedGame("");
+
+  ASSERT_NO_THROW(game.LoadAllInstalledPlugins(true));
+
+  std::filesystem::remove(dataPath / blankEsp);
+
+  ASSERT_NO_THROW(game.LoadAllInstalledPlugins(true));
+  EXPECT_FALSE(game.GetPlugin(blankEsp));
+}
+
+TEST_P(GameTest,
+       loadAllInstalledPluginsShouldReloadPluginsIfAPluginHasBeenModified) {
+  Game game = CreateInitialisedGame("");
+
+  ASSERT_NO_THROW(game.LoadAllInstalledPlugins(true));
+  auto plugin = game.GetPlugin(blankEsm);
+
+  auto lastWriteTime = std::filesystem::last_write_time(dataPath / blankEsm);
+  std::filesystem::last_write_time(dataPath / blankEsm,
+                                   lastWriteTime + std::chrono::hours(1));
+
+  ASSERT_NO_THROW(game.LoadAllInstalledPlugins(true));
+  EXPECT_NE(plugin, game.GetPlugin(blankEsm));
+}
+
+TEST_P(
+    GameTest,
+    loadAllInstalledPluginsWithHeadersOnlyFalseShouldReloadPluginsIfOnlyTheirHeadersWereLoaded) {
+  Game game = CreateInitialisedGame("");
+
+  ASSERT_NO_THROW(game.LoadAllInstalledPlugins(true));
+  ASSERT_NO_THROW(game.LoadAllInstalledPlugins(false));
+
+  EXPECT_TRUE(game.ArePluginsFullyLoaded());
+  EXPECT_EQ(blankEsmCrc, game.GetPlugin(blankEsm)->GetCRC().value());
+}
+
+TEST_P(GameTest,
+       loadAllInstalledPluginsWithHeadersOnlyTrueShouldKeepFullyLoadedPlugins) {
+  Game game = CreateInitialisedGame("");
+
+  ASSERT_NO_THROW(game.LoadAllInstalledPlugins(false));
+  ASSERT_NO_THROW(game.LoadAllInstalledPlugins(true));
+
+  EXPECT_TRUE(game.ArePluginsFullyLoaded());
+  EXPECT_EQ(blankEsmCrc, game.GetPlugin(blankEsm)->GetCRC().value());
+}
+
+TEST_P(GameTest,
+       loadAllInstalledPluginsShouldWriteAPluginCacheInTheGamesLootFolder) {
+  Game game = CreateInitialisedGame(lootDataPath);
+
+  ASSERT_NO_THROW(game.LoadAllInstalledPlugins(true));
+
+  EXPECT_TRUE(std::filesystem::exists(lootDataPath / game.FolderName() /
+                                      "plugin_cache.json"));
+}
+
+TEST_P(GameTest,
+       loadAllInstalledPluginsShouldUseCachedDataForUnchangedPlugins) {
+  Game game1 = CreateInitialisedGame(lootDataPath);
+  ASSERT_NO_THROW(game1.LoadAllInstalledPlugins(false));
+
+  // Headers-only loading doesn't normally read CRCs, so their presence
+  // means that the plugin's data came from the cache.
+  Game game2 = CreateInitialisedGame(lootDataPath);
+  ASSERT_NO_THROW(game2.LoadAllInstalledPlugins(true));
+
+  EXPECT_EQ(12, game2.GetPlugins().size());
+  EXPECT_EQ("5.0", game2.GetPlugin(blankEsm)->GetVersion().value());
+  EXPECT_EQ(blankEsmCrc, game2.GetPlugin(blankEsm)->GetCRC().value());
+}
+
+TEST_P(GameTest,
+       loadAllInstalledPluginsShouldNotUseCachedDataForChangedPlugins) {
+  Game game1 = CreateInitialisedGame(lootDataPath);
+  ASSERT_NO_THROW(game1.LoadAllInstalledPlugins(false));
+
+  auto lastWriteTime = std::filesystem::last_write_time(dataPath / blankEsm);
+  std::filesystem::last_write_time(dataPath / blankEsm,
+                                   lastWriteTime + std::chrono::hours(1));
+
+  Game game2 = CreateInitialisedGame(lootDataPath);
+  ASSERT_NO_THROW(game2.LoadAllInstalledPlugins(true));
+
+  EXPECT_FALSE(game2.GetPlugin(blankEsm)->GetCRC().has_value());
+}
+
 TEST_P(GameTest, pluginsShouldNotBeFullyLoadedByDefault) {
   Game game = CreateInitialisedGame("");
 
@@ -635,6 +802,75 @@ TEST_P(GameTest, pluginsShouldBeFullyLoadedAfterFullyLoadingThem) {
   EXPECT_TRUE(game.ArePluginsFullyLoaded());
 }
 
+TEST_P(GameTest, startBackgroundFullLoadShouldNotFullyLoadPluginsByItself) {
+  Game game = CreateInitialisedGame("");
+  game.LoadAllInstalledPlugins(true);
+
+  game.StartBackgroundFullLoad();
+
+  EXPECT_FALSE(game.ArePluginsFullyLoaded());
+}
+
+TEST_P(GameTest,
+       waitForFullyLoadedPluginsShouldFullyLoadPluginsWithoutABackgroundLoad) {
+  Game game = CreateInitialisedGame("");
+  game.LoadAllInstalledPlugins(true);
+
+  game.WaitForFullyLoadedPlugins([](size_t, size_t) {});
+
+  EXPECT_TRUE(game.ArePluginsFullyLoaded());
+  EXPECT_TRUE(game.GetPlugin(blankEsm)->GetCRC().has_value());
+}
+
+TEST_P(GameTest,
+       waitForFullyLoadedPluginsShouldUseTheBackgroundLoadedPlugins) {
+  Game game = CreateInitialisedGame("");
+  game.LoadAllInstalledPlugins(true);
+  auto pluginCount = game.GetPlugins().size();
+
+  game.StartBackgroundFullLoad();
+
+  size_t lastTotalCount = 0;
+  game.WaitForFullyLoadedPlugins(
+      [&](size_t, size_t totalCount) { lastTotalCount = totalCount; });
+
+  EXPECT_TRUE(game.ArePluginsFullyLoaded());
+  EXPECT_EQ(pluginCount, lastTotalCount);
+  EXPECT_EQ(pluginCount, game.GetPlugins().size());
+  EXPECT_TRUE(game.GetPlugin(blankEsm)->GetCRC().has_value());
+}
+
+TEST_P(GameTest,
+       waitForFullyLoadedPluginsShouldFullyLoadPluginsIfTheLoadWasCancelled) {
+  Game game = CreateInitialisedGame("");
+  game.LoadAllInstalledPlugins(true);
+
+  game.StartBackgroundFullLoad();
+  game.CancelBackgroundFullLoad();
+
+  EXPECT_FALSE(game.ArePluginsFullyLoaded());
+
+  game.WaitForFullyLoadedPlugins([](size_t, size_t) {});
+
+  EXPECT_TRUE(game.ArePluginsFullyLoaded());
+  EXPECT_TRUE(game.GetPlugin(blankEsm)->GetCRC().has_value());
+}
+
+TEST_P(GameTest,
+       waitForFullyLoadedPluginsShouldReloadPluginsThatChangedDuringALoad) {
+  Game game = CreateInitialisedGame("");
+  game.LoadAllInstalledPlugins(true);
+
+  game.StartBackgroundFullLoad();
+  std::filesystem::copy_file(dataPath / blankEsp,
+                             dataPath / "Blank.copy.esp");
+
+  game.WaitForFullyLoadedPlugins([](size_t, size_t) {});
+
+  EXPECT_TRUE(game.ArePluginsFullyLoaded());
+  EXPECT_NE(nullptr, game.GetPlugin("Blank.copy.esp"));
+}
+
 TEST_P(GameTest,
        GetActiveLoadOrderIndexShouldReturnNulloptForAPluginThatIsNotActive) {
   Game game(defaultGameSettings, "");
@@ -678,6 +914,36 @@ TEST_P(
   EXPECT_EQ(0, index.value());
 }
 
+TEST_P(
+    GameTest,
+    GetActiveLoadOrderIndicesShouldMatchGetActiveLoadOrderIndexForAllPlugins) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  auto loadOrder = game.GetLoadOrder();
+  auto indices = game.GetActiveLoadOrderIndices(loadOrder);
+
+  for (const auto& plugin : game.GetPlugins()) {
+    EXPECT_EQ(game.GetActiveLoadOrderIndex(plugin, loadOrder),
+              indices.GetIndex(plugin->GetName()))
+        << plugin->GetName();
+  }
+}
+
+TEST_P(GameTest,
+       GetActiveLoadOrderIndicesShouldCaseInsensitivelyLookUpPluginNames) {
+  Game game(defaultGameSettings, "");
+  game.Init();
+  game.LoadAllInstalledPlugins(true);
+
+  auto indices = game.GetActiveLoadOrderIndices({u8"non\u00E1scii.esp"});
+
+  EXPECT_EQ(0, indices.GetIndex(nonAsciiEsp).value());
+  EXPECT_EQ(0, indices.GetIndex(u8"non\u00E1scii.esp").value());
+  EXPECT_FALSE(indices.GetIndex(masterFile).has_value());
+}
+
 TEST_P(GameTest, setLoadOrderWithoutLoadedPluginsShouldIgnoreCurrentState) {
   using std::filesystem::u8path;
   Game game(defaultGameSettings, lootDataPath);
@@ -819,6 +1085,22 @@ TEST_P(GameTest, setLoadOrderShouldKeepUpToThreeBackups) {
   EXPECT_EQ(firstSetLoadOrder, loadOrder);
 }
 
+TEST_P(GameTest, getMetadataPathsShouldReuseThePathsUntilMetadataChanges) {
+  Game game = CreateInitialisedGame("");
+  game.LoadAllInstalledPlugins(true);
+
+  auto paths = game.GetMetadataPaths();
+  EXPECT_EQ(paths, game.GetMetadataPaths());
+
+  PluginMetadata metadata(blankEsp);
+  metadata.SetRequirements({File(blankEsm)});
+  game.AddUserMetadata(metadata);
+
+  auto newPaths = game.GetMetadataPaths();
+  EXPECT_NE(paths, newPaths);
+  EXPECT_EQ(1, newPaths->plugins.count(blankEsm));
+}
+
 TEST_P(GameTest, aMessageShouldBeCachedByDefault) {
   Game game = CreateInitialisedGame(lootDataPath);
 
@@ -25,6 +25,13 @@ along with LOOT.  If not, see
 #ifndef LOOT_TESTS_GUI_STATE_GAME_GAMES_MANAGER_TEST
 #define LOOT_TESTS_GUI_STATE_GAME_GAMES_MANAGER_TEST
 
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 #include "gui/state/game/games_manager.h"
 
 #include "tests/common_game_test_fixture.h"
@@ -33,6 +40,8 @@ namespace loot {
 namespace test {
 class TestGamesManager : public GamesManager {
 public:
+  TestGamesManager() : GamesManager(FindGamePath) {}
+
   int GetInitialiseCount(const std::string& folderName) {
     auto it = initialiseCounts_.find(folderName);
     if (it == initialiseCounts_.end()) {
@@ -42,11 +51,16 @@ public:
     }
   }
 
+  void SetMemoryUsage(const std::string& folderName, size_t memoryUsage) {
+    memoryUsages_[folderName] = memoryUsage;
+  }
+
 private:
-  std::optional<std::filesystem::path> FindGamePath(
-      const GameSettings& gameSettings) const {
+  static std::optional<std::filesystem::path> FindGamePath(
+      const GameSettings& gameSettings) {
     if (gameSettings.Type() == GameType::tes5 ||
-        gameSettings.Type() == GameType::fonv) {
+        gameSettings.Type() == GameType::fonv ||
+        gameSettings.Type() == GameType::fo4) {
       return gameSettings.GamePath() / gameSettings.FolderName();
     }
 
@@ -62,7 +76,65 @@ private:
     }
   }
 
+  size_t EstimateMemoryUsage(const gui::Game& game) const {
+    auto it = memoryUsages_.find(game.FolderName());
+    return it == memoryUsages_.end() ? 1 : it->second;
+  }
+
   mutable std::map<std::string, unsigned int> initialiseCounts_;
+  std::map<std::string, size_t> memoryUsages_;
+};
+
+class DelayedTestGamesManager : public GamesManager {
+public:
+  explicit DelayedTestGamesManager(
+      const std::map<GameType, std::chrono::milliseconds>& delays) :
+      DelayedTestGamesManager(std::make_shared<ProbeState>(delays)) {}
+
+  void SetDelay(GameType gameType, std::chrono::milliseconds delay) {
+    std::lock_guard<std::mutex> guard(state_->mutex);
+    state_->delays[gameType] = delay;
+  }
+
+  size_t GetProbeCount() const { return state_->probeCount; }
+
+private:
+  // Shared with the probes, as they may outlive the manager.
+  struct ProbeState {
+    explicit ProbeState(
+        const std::map<GameType, std::chrono::milliseconds>& delays) :
+        delays(delays), probeCount(0) {}
+
+    std::mutex mutex;
+    std::map<GameType, std::chrono::milliseconds> delays;
+    std::atomic<size_t> probeCount;
+  };
+
+  explicit DelayedTestGamesManager(std::shared_ptr<ProbeState> state) :
+      GamesManager([state](const GameSettings& gameSettings)
+                       -> std::optional<std::filesystem::path> {
+        ++state->probeCount;
+
+        std::chrono::milliseconds delay;
+        {
+          std::lock_guard<std::mutex> guard(state->mutex);
+          auto it = state->delays.find(gameSettings.Type());
+          if (it == state->delays.end()) {
+            return std::nullopt;
+          }
+          delay = it->second;
+        }
+
+        std::this_thread::sleep_for(delay);
+
+        return gameSettings.GamePath() / gameSettings.FolderName();
+      }),
+      state_(state) {}
+
+  void InitialiseGameData(gui::Game&) {}
+  size_t EstimateMemoryUsage(const gui::Game&) const { return 0; }
+
+  std::shared_ptr<ProbeState> state_;
 };
 
 TEST(GamesManager,
@@ -98,6 +170,144 @@ TEST(GamesManager, loadInstalledGamesShouldSetTheGamePathsOfInstalledGames) {
   EXPECT_EQ("FalloutNV", settings[2].GamePath());
 }
 
+TEST(GamesManager,
+     loadInstalledGamesShouldKeepSettingsOrderIfGamesAreDetectedOutOfOrder) {
+  using std::chrono::milliseconds;
+  DelayedTestGamesManager manager({
+      {GameType::tes4, milliseconds(100)},
+      {GameType::tes5, milliseconds(50)},
+      {GameType::fonv, milliseconds(0)},
+  });
+  auto settings = manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes4),
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+      },
+      std::filesystem::path());
+
+  EXPECT_EQ(std::vector<std::string>({"Oblivion", "Skyrim", "FalloutNV"}),
+            manager.GetInstalledGameFolderNames());
+
+  ASSERT_EQ(3, settings.size());
+  EXPECT_EQ("Oblivion", settings[0].GamePath());
+  EXPECT_EQ("Skyrim", settings[1].GamePath());
+  EXPECT_EQ("FalloutNV", settings[2].GamePath());
+}
+
+TEST(GamesManager, loadInstalledGamesShouldDetectGamesConcurrently) {
+  using std::chrono::milliseconds;
+  DelayedTestGamesManager manager({
+      {GameType::tes4, milliseconds(200)},
+      {GameType::tes5, milliseconds(200)},
+      {GameType::fonv, milliseconds(200)},
+  });
+
+  auto start = std::chrono::steady_clock::now();
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes4),
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+      },
+      std::filesystem::path());
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(3, manager.GetInstalledGameFolderNames().size());
+  EXPECT_LT(elapsed, milliseconds(600));
+}
+
+TEST(GamesManager,
+     loadInstalledGamesShouldTreatGamesThatTimeOutAsNotInstalled) {
+  using std::chrono::milliseconds;
+  DelayedTestGamesManager manager({
+      {GameType::tes4, milliseconds(2000)},
+      {GameType::tes5, milliseconds(0)},
+  });
+  manager.SetGameDetectionTimeout(milliseconds(200));
+
+  auto start = std::chrono::steady_clock::now();
+  auto settings = manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes4),
+          GameSettings(GameType::tes5),
+      },
+      std::filesystem::path());
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(std::vector<std::string>({"Skyrim"}),
+            manager.GetInstalledGameFolderNames());
+  EXPECT_LT(elapsed, milliseconds(2000));
+
+  ASSERT_EQ(2, settings.size());
+  EXPECT_EQ(GameSettings(GameType::tes4).GamePath(), settings[0].GamePath());
+  EXPECT_EQ("Skyrim", settings[1].GamePath());
+}
+
+TEST(GamesManager,
+     aGameDetectionProbeThatTimesOutShouldBeAbleToOutliveTheManager) {
+  using std::chrono::milliseconds;
+  {
+    DelayedTestGamesManager manager({{GameType::tes4, milliseconds(100)}});
+    manager.SetGameDetectionTimeout(milliseconds(0));
+
+    manager.LoadInstalledGames({GameSettings(GameType::tes4)},
+                               std::filesystem::path());
+
+    EXPECT_TRUE(manager.GetInstalledGameFolderNames().empty());
+  }
+
+  // Let the probe finish after the manager has been destroyed, which would
+  // crash or be flagged by sanitizers if the probe referred to the manager.
+  std::this_thread::sleep_for(milliseconds(200));
+}
+
+TEST(GamesManager,
+     loadInstalledGamesShouldNotProbeAGameAgainWhileItsLastProbeIsRunning) {
+  using std::chrono::milliseconds;
+  DelayedTestGamesManager manager({{GameType::tes4, milliseconds(500)}});
+  manager.SetGameDetectionTimeout(milliseconds(0));
+
+  manager.LoadInstalledGames({GameSettings(GameType::tes4)},
+                             std::filesystem::path());
+  manager.LoadInstalledGames({GameSettings(GameType::tes4)},
+                             std::filesystem::path());
+
+  EXPECT_EQ(1, manager.GetProbeCount());
+}
+
+TEST(GamesManager,
+     loadInstalledGamesShouldProbeAGameAgainOnceItsLastProbeHasFinished) {
+  using std::chrono::milliseconds;
+  DelayedTestGamesManager manager({{GameType::tes4, milliseconds(0)}});
+
+  manager.LoadInstalledGames({GameSettings(GameType::tes4)},
+                             std::filesystem::path());
+  manager.LoadInstalledGames({GameSettings(GameType::tes4)},
+                             std::filesystem::path());
+
+  EXPECT_EQ(2, manager.GetProbeCount());
+}
+
+TEST(GamesManager,
+     loadInstalledGamesShouldKeepTheCurrentGameIfItsProbeTimesOut) {
+  using std::chrono::milliseconds;
+  DelayedTestGamesManager manager({{GameType::tes5, milliseconds(0)}});
+  manager.LoadInstalledGames({GameSettings(GameType::tes5)},
+                             std::filesystem::path());
+  manager.SetCurrentGame("Skyrim");
+
+  manager.SetDelay(GameType::tes5, milliseconds(500));
+  manager.SetGameDetectionTimeout(milliseconds(0));
+
+  EXPECT_NO_THROW(manager.LoadInstalledGames({GameSettings(GameType::tes5)},
+                                             std::filesystem::path()));
+  EXPECT_EQ("Skyrim", manager.GetCurrentGame().FolderName());
+  EXPECT_EQ("Skyrim", manager.GetCurrentGame().GamePath());
+  EXPECT_EQ(std::vector<std::string>({"Skyrim"}),
+            manager.GetInstalledGameFolderNames());
+}
+
 TEST(
     GamesManager,
     loadInstalledGamesShouldThrowAnExceptionIfTheCurrentGameIsNoLongerInstalled) {
@@ -248,6 +458,46 @@ TEST(
   EXPECT_EQ(newGameSettings.RepoBranch(), settings[0].RepoBranch());
 }
 
+TEST(GamesManager, loadInstalledGamesShouldNotInitialiseAnyGames) {
+  TestGamesManager manager;
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes4),
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+      },
+      std::filesystem::path());
+
+  EXPECT_EQ(
+      0, manager.GetInitialiseCount(GameSettings(GameType::tes5).FolderName()));
+  EXPECT_EQ(
+      0, manager.GetInitialiseCount(GameSettings(GameType::fonv).FolderName()));
+}
+
+TEST(
+    GamesManager,
+    loadInstalledGamesShouldNotInvalidateCurrentGameReferenceIfItIsUnchanged) {
+  TestGamesManager manager;
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+      },
+      std::filesystem::path());
+
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+  auto& currentGame = manager.GetCurrentGame();
+
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes4),
+          GameSettings(GameType::tes5),
+      },
+      std::filesystem::path());
+
+  EXPECT_EQ(&currentGame, &manager.GetCurrentGame());
+}
+
 TEST(GamesManager, getCurrentGameShouldThrowIfNoGamesAreInstalled) {
   TestGamesManager manager;
   EXPECT_THROW(manager.GetCurrentGame(), std::runtime_error);
@@ -267,6 +517,21 @@ TEST(GamesManager, setCurrentGameShouldThrowIfTheGivenGameIsNotInstalled) {
   EXPECT_THROW(manager.SetCurrentGame("invalid"), GameDetectionError);
 }
 
+TEST(GamesManager,
+     setCurrentGameShouldKeepTheCurrentGameIfTheGivenGameIsNotInstalled) {
+  TestGamesManager manager;
+  manager.LoadInstalledGames({GameSettings(GameType::tes5)},
+                             std::filesystem::path());
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+  auto& currentGame = manager.GetCurrentGame();
+
+  EXPECT_THROW(manager.SetCurrentGame("invalid"), GameDetectionError);
+
+  EXPECT_EQ(&currentGame, &manager.GetCurrentGame());
+  EXPECT_EQ(
+      1, manager.GetInitialiseCount(GameSettings(GameType::tes5).FolderName()));
+}
+
 TEST(GamesManager, setCurrentGameShouldUpdateStoredReference) {
   TestGamesManager manager;
   auto settings = manager.LoadInstalledGames(
@@ -299,6 +564,117 @@ TEST(GamesManager, setCurrentGameShouldInitialiseGameData) {
       1, manager.GetInitialiseCount(GameSettings(GameType::tes5).FolderName()));
 }
 
+TEST(GamesManager,
+     setCurrentGameShouldReinitialiseAPreviousGameIfTheBudgetIsZero) {
+  TestGamesManager manager;
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+      },
+      std::filesystem::path());
+
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+  manager.SetCurrentGame(GameSettings(GameType::fonv).FolderName());
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+
+  EXPECT_EQ(
+      2, manager.GetInitialiseCount(GameSettings(GameType::tes5).FolderName()));
+}
+
+TEST(GamesManager,
+     setCurrentGameShouldReuseAPreviousGameThatFitsWithinTheBudget) {
+  TestGamesManager manager;
+  manager.SetInactiveGamesMemoryBudget(1);
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+      },
+      std::filesystem::path());
+
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+  auto& game = manager.GetCurrentGame();
+  manager.SetCurrentGame(GameSettings(GameType::fonv).FolderName());
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+
+  EXPECT_EQ(&game, &manager.GetCurrentGame());
+  EXPECT_EQ(
+      1, manager.GetInitialiseCount(GameSettings(GameType::tes5).FolderName()));
+}
+
+TEST(GamesManager,
+     setCurrentGameShouldDiscardTheLeastRecentlyUsedGamesOverTheBudget) {
+  TestGamesManager manager;
+  manager.SetInactiveGamesMemoryBudget(1);
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+          GameSettings(GameType::fo4),
+      },
+      std::filesystem::path());
+
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+  manager.SetCurrentGame(GameSettings(GameType::fonv).FolderName());
+  manager.SetCurrentGame(GameSettings(GameType::fo4).FolderName());
+  manager.SetCurrentGame(GameSettings(GameType::fonv).FolderName());
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+
+  EXPECT_EQ(
+      2, manager.GetInitialiseCount(GameSettings(GameType::tes5).FolderName()));
+  EXPECT_EQ(
+      1, manager.GetInitialiseCount(GameSettings(GameType::fonv).FolderName()));
+}
+
+TEST(GamesManager,
+     setInactiveGamesMemoryBudgetShouldDiscardGamesThatNoLongerFit) {
+  TestGamesManager manager;
+  manager.SetInactiveGamesMemoryBudget(100);
+  manager.SetMemoryUsage(GameSettings(GameType::tes5).FolderName(), 50);
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+      },
+      std::filesystem::path());
+
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+  manager.SetCurrentGame(GameSettings(GameType::fonv).FolderName());
+  manager.SetInactiveGamesMemoryBudget(49);
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+
+  EXPECT_EQ(
+      2, manager.GetInitialiseCount(GameSettings(GameType::tes5).FolderName()));
+}
+
+TEST(GamesManager,
+     loadInstalledGamesShouldDiscardAPreviousGameIfItsPathHasChanged) {
+  TestGamesManager manager;
+  manager.SetInactiveGamesMemoryBudget(100);
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5),
+          GameSettings(GameType::fonv),
+      },
+      std::filesystem::path());
+
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+  manager.SetCurrentGame(GameSettings(GameType::fonv).FolderName());
+
+  manager.LoadInstalledGames(
+      {
+          GameSettings(GameType::tes5).SetGamePath("different"),
+          GameSettings(GameType::fonv),
+      },
+      std::filesystem::path());
+  manager.SetCurrentGame(GameSettings(GameType::tes5).FolderName());
+
+  EXPECT_EQ(
+      2, manager.GetInitialiseCount(GameSettings(GameType::tes5).FolderName()));
+  EXPECT_EQ("different/Skyrim", manager.GetCurrentGame().GamePath());
+}
+
 TEST(GamesManager,
      getFirstInstalledGameFolderNameShouldReturnNulloptIfNoGamesAreInstalled) {
   TestGamesManager manager;
@@ -27,10 +27,19 @@
 
 #include "gui/state/game/helpers.h"
 
+#include <regex>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 namespace loot {
 namespace test {
+// The regex-based implementation that EscapeMarkdownSpecialChars replaced,
+// kept to check that the current implementation gives the same output.
+std::string RegexEscapeMarkdownSpecialChars(std::string text) {
+  auto specialCharsRegex = std::regex("([\\\\`*_{}\\[\\]()#+.!-])");
+  return std::regex_replace(text, specialCharsRegex, "\\$1");
+}
 
 TEST(EscapeMarkdownSpecialChars, shouldEscapeBackslash) {
   EXPECT_EQ("\\\\", EscapeMarkdownSpecialChars("\\"));
@@ -88,6 +97,54 @@ TEST(EscapeMarkdownSpecialChars, shouldNotEscapeNonSpecialCharacters) {
   EXPECT_EQ(text, EscapeMarkdownSpecialChars(text));
 }
 
+TEST(EscapeMarkdownSpecialChars, shouldEscapeConsecutiveSpecialCharacters) {
+  EXPECT_EQ("a\\.\\.\\.b", EscapeMarkdownSpecialChars("a...b"));
+}
+
+TEST(EscapeMarkdownSpecialChars, shouldNotEscapeNonAsciiCharacters) {
+  auto text = u8"nonAsc\u00EDi \u2192 \u00E9";
+  EXPECT_EQ(text, EscapeMarkdownSpecialChars(text));
+}
+
+TEST(EscapeMarkdownSpecialChars,
+     shouldGiveTheSameOutputAsTheRegexImplementationForAllCharacters) {
+  std::string text;
+  for (int i = 0; i < 256; ++i) {
+    text += static_cast<char>(i);
+  }
+
+  EXPECT_EQ(RegexEscapeMarkdownSpecialChars(text),
+            EscapeMarkdownSpecialChars(text));
+}
+
+TEST(EscapeMarkdownSpecialChars,
+     shouldGiveTheSameOutputAsTheRegexImplementationForMessageText) {
+  // Text like that passed to PlainTextMessage when checking install validity
+  // and describing cycles.
+  std::vector<std::string> texts = {
+      "",
+      "Plugin names without any special characters",
+      "This plugin requires \"Unofficial Skyrim Special Edition Patch.esp\" "
+      "to be installed, but it is missing.",
+      "This plugin is a light master and requires the non-master plugin "
+      "\"[Cobb] Positioner.esp\". This can cause issues in-game, and sorting "
+      "will fail while this plugin is installed.",
+      "This plugin has a header version of 0.94, which is less than the "
+      "game's minimum supported header version of 1.7.",
+      u8"Immersive Citizens - AI Overhaul.esp [Master Flag] "
+      u8"\u2192 Alternate Start - Live Another Life.esp",
+      "C:\\Games\\Skyrim\\Data\\textures\\*.dds",
+      "\\\\``**__{{}}[[]]))((##++--..!!",
+      "**bold** _italic_ `code` [link](https://loot.github.io/) #1 - 2 + 3!",
+  };
+
+  for (const auto& text : texts) {
+    EXPECT_EQ(RegexEscapeMarkdownSpecialChars(text),
+              EscapeMarkdownSpecialChars(text))
+        << "for text: " << text;
+  }
+}
+
 TEST(PlainTextMessage, shouldEscapeMarkdownSpecialCharacters) {
   auto message = PlainTextMessage(MessageType::say, "normal text\\`*_{}[]()#+-.!");
 
@@ -0,0 +1,147 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_GAME_LOAD_ORDER_INDEX_TABLE_TEST
+#define LOOT_TESTS_GUI_STATE_GAME_LOAD_ORDER_INDEX_TABLE_TEST
+
+#include "gui/state/game/load_order_index_table.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace loot {
+namespace test {
+TEST(LoadOrderIndexTable,
+     getIndexShouldReturnNulloptForAPluginThatWasNotAdded) {
+  LoadOrderIndexTable indices;
+  indices.AddActivePlugin("Blank.esp", false);
+
+  EXPECT_FALSE(indices.GetIndex("Blank.esm").has_value());
+}
+
+TEST(LoadOrderIndexTable, getIndexShouldBeCaseInsensitive) {
+  LoadOrderIndexTable indices;
+  indices.AddActivePlugin("Blank.esp", false);
+
+  EXPECT_EQ(0, indices.GetIndex("blank.ESP").value());
+}
+
+TEST(LoadOrderIndexTable, lightPluginsShouldBeIndexedSeparatelyToFullPlugins) {
+  LoadOrderIndexTable indices;
+  indices.AddActivePlugin("Blank.esm", false);
+  indices.AddActivePlugin("Blank.esl", true);
+  indices.AddActivePlugin("Blank.esp", false);
+
+  EXPECT_EQ(0, indices.GetIndex("Blank.esm").value());
+  EXPECT_EQ(0, indices.GetIndex("Blank.esl").value());
+  EXPECT_EQ(1, indices.GetIndex("Blank.esp").value());
+  EXPECT_EQ(2, indices.GetActiveFullPluginCount());
+  EXPECT_EQ(1, indices.GetActiveLightPluginCount());
+}
+
+TEST(LoadOrderIndexTable, addingAPluginAgainShouldNotChangeItsIndex) {
+  LoadOrderIndexTable indices;
+  indices.AddActivePlugin("Blank.esm", false);
+  indices.AddActivePlugin("Blank.esp", false);
+  indices.AddActivePlugin("blank.esm", false);
+
+  EXPECT_EQ(0, indices.GetIndex("Blank.esm").value());
+  EXPECT_EQ(2, indices.GetActiveFullPluginCount());
+}
+
+TEST(LoadOrderIndexTable,
+     activePluginsFingerprintShouldNotDependOnTheLoadOrder) {
+  LoadOrderIndexTable indices;
+  indices.AddActivePlugin("Blank.esm", false);
+  indices.AddActivePlugin("Blank.esp", false);
+  LoadOrderIndexTable otherIndices;
+  otherIndices.AddActivePlugin("blank.esp", false);
+  otherIndices.AddActivePlugin("Blank.esm", false);
+
+  EXPECT_EQ(indices.GetActivePluginsFingerprint(),
+            otherIndices.GetActivePluginsFingerprint());
+}
+
+TEST(LoadOrderIndexTable,
+     activePluginsFingerprintShouldChangeIfAPluginIsAdded) {
+  LoadOrderIndexTable indices;
+  indices.AddActivePlugin("Blank.esm", false);
+  auto fingerprint = indices.GetActivePluginsFingerprint();
+
+  indices.AddActivePlugin("Blank.esp", false);
+
+  EXPECT_NE(fingerprint, indices.GetActivePluginsFingerprint());
+}
+
+TEST(LoadOrderIndexTable, shouldHoldTheIndicesOfAllPluginsInALargeLoadOrder) {
+  const short pluginCount = 4096;
+  LoadOrderIndexTable indices;
+  for (short i = 0; i < pluginCount; ++i) {
+    indices.AddActivePlugin("Blank" + std::to_string(i) + ".esp", i % 2 == 1);
+  }
+
+  for (short i = 0; i < pluginCount; ++i) {
+    EXPECT_EQ(i / 2, indices.GetIndex("Blank" + std::to_string(i) + ".esp"));
+  }
+  EXPECT_EQ(pluginCount / 2, indices.GetActiveFullPluginCount());
+  EXPECT_EQ(pluginCount / 2, indices.GetActiveLightPluginCount());
+}
+
+// This isn't a pass/fail test, it records how long a large load order takes
+// to index and look up in the test results, so that changes in performance
+// can be tracked without the test depending on the machine's speed.
+TEST(LoadOrderIndexTable, benchmarkIndexingALargeLoadOrder) {
+  const short pluginCount = 4096;
+  std::vector<std::string> pluginNames;
+  for (short i = 0; i < pluginCount; ++i) {
+    pluginNames.push_back("Blank" + std::to_string(i) + ".esp");
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  LoadOrderIndexTable indices;
+  for (short i = 0; i < pluginCount; ++i) {
+    indices.AddActivePlugin(pluginNames[i], i % 2 == 1);
+  }
+  auto indexed = std::chrono::steady_clock::now();
+  for (const auto& pluginName : pluginNames) {
+    indices.GetIndex(pluginName);
+  }
+  auto lookedUp = std::chrono::steady_clock::now();
+
+  auto toMicroseconds = [](std::chrono::steady_clock::duration duration) {
+    return static_cast<int>(
+        std::chrono::duration_cast<std::chrono::microseconds>(duration)
+            .count());
+  };
+  RecordProperty("pluginCount", pluginCount);
+  RecordProperty("indexingMicroseconds", toMicroseconds(indexed - start));
+  RecordProperty("lookupMicroseconds", toMicroseconds(lookedUp - indexed));
+}
+}
+}
+
+#endif
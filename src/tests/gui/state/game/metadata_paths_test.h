@@ -0,0 +1,109 @@
+/*  LOOT
+
+    A load order optimisation tool for
+    Morrowind, Oblivion, Skyrim, Skyrim Special Edition, Skyrim VR,
+    Fallout 3, Fallout: New Vegas, Fallout 4 and Fallout 4 VR.
+
+    Copyright (C) 2021    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_GAME_METADATA_PATHS_TEST
+#define LOOT_TESTS_GUI_STATE_GAME_METADATA_PATHS_TEST
+
+#include "gui/state/game/metadata_paths.h"
+
+#include <gtest/gtest.h>
+
+#include "tests/gui/test_helpers.h"
+
+namespace loot {
+namespace test {
+class MetadataPathsTest : public ::testing::Test {
+protected:
+  MetadataPathsTest() :
+      plugins_({std::make_shared<TestPlugin>("Blank.esm"),
+                std::make_shared<TestPlugin>("Blank.esp")}),
+      metadata_("Blank.esp") {}
+
+  MetadataPaths findPaths(const std::string& condition) {
+    metadata_.SetMessages({Message(MessageType::say, "text", condition)});
+    return FindMetadataPaths(plugins_, {metadata_});
+  }
+
+  const std::vector<std::shared_ptr<const PluginInterface>> plugins_;
+  PluginMetadata metadata_;
+};
+
+TEST_F(MetadataPathsTest, shouldFindLoadedPluginsUsingTheirLoadedNames) {
+  auto paths = findPaths("version(\"blank.esm\", \"1.0\", ==)");
+
+  EXPECT_EQ(std::unordered_set<std::string>({"Blank.esm"}), paths.plugins);
+  EXPECT_TRUE(paths.files.empty());
+}
+
+TEST_F(MetadataPathsTest, shouldFindFilesThatConditionsReadTheContentOf) {
+  auto paths = findPaths("checksum(\"Blank.bsa\", DEADBEEF)");
+
+  EXPECT_TRUE(paths.plugins.empty());
+  EXPECT_EQ(std::unordered_set<std::string>({"Blank.bsa"}), paths.files);
+}
+
+TEST_F(MetadataPathsTest,
+       shouldNotFindFilesThatAreOnlyCheckedForExistenceInTheDataDirectory) {
+  auto paths = findPaths("file(\"Blank.bsa\") or many(\"Blank.*\")");
+
+  EXPECT_TRUE(paths.files.empty());
+}
+
+TEST_F(MetadataPathsTest,
+       shouldFindFilesInSubdirectoriesThatAreCheckedToExist) {
+  auto paths = findPaths("file(\"textures/Blank.dds\")");
+
+  EXPECT_EQ(std::unordered_set<std::string>({"textures/Blank.dds"}),
+            paths.files);
+}
+
+TEST_F(MetadataPathsTest,
+       shouldFindFilesThatAreCheckedToExistIfTheirContentIsAlsoRead) {
+  auto paths = findPaths(
+      "file(\"Blank.bsa\") and not checksum(\"Blank.bsa\", DEADBEEF)");
+
+  EXPECT_EQ(std::unordered_set<std::string>({"Blank.bsa"}), paths.files);
+}
+
+TEST_F(MetadataPathsTest, shouldNotFindPathsThatAreOnlyCheckedToBeActive) {
+  auto paths = findPaths("active(\"Other.esp\")");
+
+  EXPECT_TRUE(paths.plugins.empty());
+  EXPECT_TRUE(paths.files.empty());
+}
+
+TEST_F(MetadataPathsTest, shouldFindRequirementsInSubdirectories) {
+  metadata_.SetRequirements({File("Blank.esm"), File("textures/Blank.dds")});
+
+  auto paths = FindMetadataPaths(plugins_, {metadata_});
+
+  EXPECT_EQ(std::unordered_set<std::string>({"Blank.esm"}), paths.plugins);
+  EXPECT_EQ(std::unordered_set<std::string>({"textures/Blank.dds"}),
+            paths.files);
+}
+}
+}
+
+#endif
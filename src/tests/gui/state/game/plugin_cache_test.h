@@ -0,0 +1,252 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+#ifndef LOOT_TESTS_GUI_STATE_GAME_PLUGIN_CACHE_TEST
+#define LOOT_TESTS_GUI_STATE_GAME_PLUGIN_CACHE_TEST
+
+#include "gui/state/game/plugin_cache.h"
+
+#include <gtest/gtest.h>
+
+#include "tests/gui/test_helpers.h"
+
+namespace loot {
+namespace test {
+class FullyLoadedTestPlugin : public TestPlugin {
+public:
+  FullyLoadedTestPlugin(std::string name) : TestPlugin(name) {}
+
+  std::optional<std::string> GetVersion() const override { return "1.0"; }
+
+  std::vector<std::string> GetMasters() const override {
+    return {"Blank.esm"};
+  }
+
+  std::vector<Tag> GetBashTags() const override {
+    return {Tag("Relev"), Tag("Delev", false)};
+  }
+
+  std::optional<uint32_t> GetCRC() const override { return 0x12345678; }
+
+  bool IsMaster() const override { return true; }
+};
+
+class PluginCacheTest : public ::testing::Test {
+public:
+  PluginCacheTest() :
+      cachePath(getTempPath() / "plugin_cache.json"),
+      installedPlugin{"Blank.esp", 100, std::filesystem::file_time_type()} {}
+
+protected:
+  void SetUp() override {
+    std::filesystem::create_directories(cachePath.parent_path());
+  }
+
+  void TearDown() override {
+    std::filesystem::remove_all(cachePath.parent_path());
+  }
+
+  const std::filesystem::path cachePath;
+  const InstalledPlugin installedPlugin;
+};
+
+TEST_F(PluginCacheTest, findShouldReturnNullptrIfThePluginIsNotCached) {
+  PluginCache cache(cachePath);
+
+  EXPECT_FALSE(cache.Find(installedPlugin));
+}
+
+TEST_F(PluginCacheTest, findShouldReturnTheCachedPluginIfTheFileIsUnchanged) {
+  PluginCache cache(cachePath);
+  cache.Update(installedPlugin, FullyLoadedTestPlugin("Blank.esp"));
+
+  auto plugin = cache.Find(installedPlugin);
+
+  ASSERT_TRUE(plugin);
+  EXPECT_EQ("Blank.esp", plugin->GetName());
+  EXPECT_EQ(0x12345678, plugin->GetCRC());
+}
+
+TEST_F(PluginCacheTest, findShouldReturnNullptrIfTheFileSizeHasChanged) {
+  PluginCache cache(cachePath);
+  cache.Update(installedPlugin, FullyLoadedTestPlugin("Blank.esp"));
+
+  auto changedPlugin = installedPlugin;
+  changedPlugin.size += 1;
+
+  EXPECT_FALSE(cache.Find(changedPlugin));
+}
+
+TEST_F(PluginCacheTest, findShouldReturnNullptrIfTheLastWriteTimeHasChanged) {
+  PluginCache cache(cachePath);
+  cache.Update(installedPlugin, FullyLoadedTestPlugin("Blank.esp"));
+
+  auto changedPlugin = installedPlugin;
+  changedPlugin.lastWriteTime += std::chrono::seconds(1);
+
+  EXPECT_FALSE(cache.Find(changedPlugin));
+}
+
+TEST_F(PluginCacheTest, updateShouldKeepTheCachedPluginIfTheFileIsUnchanged) {
+  PluginCache cache(cachePath);
+  cache.Update(installedPlugin, FullyLoadedTestPlugin("Blank.esp"));
+  auto cachedPlugin = cache.Find(installedPlugin);
+
+  cache.Update(installedPlugin, FullyLoadedTestPlugin("Blank.esp"));
+
+  EXPECT_EQ(cachedPlugin, cache.Find(installedPlugin));
+}
+
+TEST_F(PluginCacheTest,
+       updateShouldReplaceTheCachedPluginIfTheFileHasChanged) {
+  PluginCache cache(cachePath);
+  cache.Update(installedPlugin, FullyLoadedTestPlugin("Blank.esp"));
+  auto cachedPlugin = cache.Find(installedPlugin);
+
+  auto changedPlugin = installedPlugin;
+  changedPlugin.size += 1;
+  cache.Update(changedPlugin, FullyLoadedTestPlugin("Blank.esp"));
+
+  ASSERT_TRUE(cache.Find(changedPlugin));
+  EXPECT_NE(cachedPlugin, cache.Find(changedPlugin));
+}
+
+TEST_F(PluginCacheTest,
+       updateShouldReplaceACachedPluginWithNoCrcIfTheNewPluginHasACrc) {
+  PluginCache cache(cachePath);
+  cache.Update(installedPlugin, TestPlugin("Blank.esp"));
+
+  cache.Update(installedPlugin, FullyLoadedTestPlugin("Blank.esp"));
+
+  auto plugin = cache.Find(installedPlugin);
+  ASSERT_TRUE(plugin);
+  EXPECT_EQ(0x12345678, plugin->GetCRC());
+}
+
+TEST_F(PluginCacheTest, retainShouldRemovePluginsThatAreNotInstalled) {
+  InstalledPlugin otherPlugin{"Blank.esm", 10, installedPlugin.lastWriteTime};
+
+  PluginCache cache(cachePath);
+  cache.Update(installedPlugin, FullyLoadedTestPlugin("Blank.esp"));
+  cache.Update(otherPlugin, FullyLoadedTestPlugin("Blank.esm"));
+
+  cache.Retain({otherPlugin});
+
+  EXPECT_EQ(1, cache.Size());
+  EXPECT_FALSE(cache.Find(installedPlugin));
+  EXPECT_TRUE(cache.Find(otherPlugin));
+}
+
+TEST_F(PluginCacheTest, loadShouldReadTheDataThatSaveWrote) {
+  FullyLoadedTestPlugin original("Blank.esp");
+  PluginCache cache(cachePath);
+  cache.Update(installedPlugin, original);
+  cache.Save();
+
+  PluginCache loadedCache(cachePath);
+  loadedCache.Load();
+
+  auto plugin = loadedCache.Find(installedPlugin);
+  ASSERT_TRUE(plugin);
+  EXPECT_EQ(original.GetName(), plugin->GetName());
+  EXPECT_EQ(original.GetHeaderVersion(), plugin->GetHeaderVersion());
+  EXPECT_EQ(original.GetVersion(), plugin->GetVersion());
+  EXPECT_EQ(original.GetMasters(), plugin->GetMasters());
+  EXPECT_EQ(original.GetBashTags(), plugin->GetBashTags());
+  EXPECT_EQ(original.GetCRC(), plugin->GetCRC());
+  EXPECT_EQ(original.IsMaster(), plugin->IsMaster());
+  EXPECT_EQ(original.IsLightPlugin(), plugin->IsLightPlugin());
+  EXPECT_EQ(original.IsEmpty(), plugin->IsEmpty());
+  EXPECT_EQ(original.LoadsArchive(), plugin->LoadsArchive());
+}
+
+TEST_F(PluginCacheTest, saveShouldNotLeaveATemporaryFile) {
+  PluginCache cache(cachePath);
+  cache.Update(installedPlugin, FullyLoadedTestPlugin("Blank.esp"));
+  cache.Save();
+
+  EXPECT_TRUE(std::filesystem::exists(cachePath));
+  EXPECT_EQ(1,
+            std::distance(
+                std::filesystem::directory_iterator(cachePath.parent_path()),
+                std::filesystem::directory_iterator()));
+}
+
+TEST_F(PluginCacheTest, saveShouldNotWriteTheFileIfNothingHasChanged) {
+  PluginCache cache(cachePath);
+  cache.Update(installedPlugin, FullyLoadedTestPlugin("Blank.esp"));
+  cache.Save();
+
+  PluginCache loadedCache(cachePath);
+  loadedCache.Load();
+  loadedCache.Update(installedPlugin, FullyLoadedTestPlugin("Blank.esp"));
+  loadedCache.Retain({installedPlugin});
+
+  std::filesystem::remove(cachePath);
+  loadedCache.Save();
+  cache.Save();
+
+  EXPECT_FALSE(std::filesystem::exists(cachePath));
+}
+
+TEST_F(PluginCacheTest, saveShouldWriteTheFileIfAPluginWasRemoved) {
+  PluginCache cache(cachePath);
+  cache.Update(installedPlugin, FullyLoadedTestPlugin("Blank.esp"));
+  cache.Save();
+  std::filesystem::remove(cachePath);
+
+  cache.Retain({});
+  cache.Save();
+
+  PluginCache loadedCache(cachePath);
+  loadedCache.Load();
+
+  EXPECT_TRUE(std::filesystem::exists(cachePath));
+  EXPECT_EQ(0, loadedCache.Size());
+}
+
+TEST_F(PluginCacheTest, loadShouldLeaveTheCacheEmptyIfTheFileIsInvalid) {
+  std::ofstream out(cachePath);
+  out << "invalid";
+  out.close();
+
+  PluginCache cache(cachePath);
+  EXPECT_NO_THROW(cache.Load());
+
+  EXPECT_EQ(0, cache.Size());
+}
+
+TEST_F(PluginCacheTest, loadShouldIgnoreACacheFileWithADifferentVersion) {
+  std::ofstream out(cachePath);
+  out << R"({"version": 0, "plugins": []})";
+  out.close();
+
+  PluginCache cache(cachePath);
+  EXPECT_NO_THROW(cache.Load());
+
+  EXPECT_EQ(0, cache.Size());
+}
+}
+}
+
+#endif
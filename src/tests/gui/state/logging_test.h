@@ -0,0 +1,253 @@
+/*  LOOT
+
+    A load order optimisation tool for Oblivion, Skyrim, Fallout 3 and
+    Fallout: New Vegas.
+
+    Copyright (C) 2018    Oliver Hamlet
+
+    This file is part of LOOT.
+
+    LOOT is free software: you can redistribute
+    it and/or modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation, either version 3 of
+    the License, or (at your option) any later version.
+
+    LOOT is distributed in the hope that it will
+    be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with LOOT.  If not, see
+    <https://www.gnu.org/licenses/>.
+    */
+
+#ifndef LOOT_TESTS_GUI_STATE_LOGGING_TEST
+#define LOOT_TESTS_GUI_STATE_LOGGING_TEST
+
+#include "gui/state/logging.h"
+
+#include <gtest/gtest.h>
+#include <spdlog/sinks/null_sink.h>
+#include <zlib.h>
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace loot {
+namespace test {
+class LoggingTest : public ::testing::Test {
+protected:
+  LoggingTest() :
+      logPath_(std::filesystem::temp_directory_path() /
+               "LOOT-logging-test.txt"),
+      rotatedLogPath_(std::filesystem::temp_directory_path() /
+                      "LOOT-logging-test.1.txt.gz") {}
+
+  void TearDown() {
+    shutdownLogging();
+    std::filesystem::remove(logPath_);
+    for (size_t i = 1; i <= LogFileOptions().maxRotatedFiles; ++i) {
+      std::filesystem::remove(
+          logPath_.parent_path() /
+          ("LOOT-logging-test." + std::to_string(i) + ".txt.gz"));
+    }
+
+    // Restore the null logger that the rest of the tests use.
+    spdlog::create<spdlog::sinks::null_sink_st>("loot_logger");
+  }
+
+  std::string readLog() const { return readFile(logPath_); }
+
+  static std::string readFile(const std::filesystem::path& path) {
+    std::ifstream in(path);
+    std::stringstream content;
+    content << in.rdbuf();
+    return content.str();
+  }
+
+  static std::string readGzipFile(const std::filesystem::path& path) {
+    auto in = gzopen(path.u8string().c_str(), "rb");
+    if (in == nullptr) {
+      return "";
+    }
+
+    std::string content;
+    char buffer[1024];
+    int count = 0;
+    while ((count = gzread(in, buffer, sizeof(buffer))) > 0) {
+      content.append(buffer, count);
+    }
+    gzclose(in);
+
+    return content;
+  }
+
+  bool waitForLogToContain(const std::string& text,
+                           std::chrono::milliseconds timeout) const {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (std::chrono::steady_clock::now() < deadline) {
+      if (readLog().find(text) != std::string::npos) {
+        return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    return false;
+  }
+
+  static void writeFile(const std::filesystem::path& path,
+                        const std::string& content) {
+    std::ofstream out(path);
+    out << content;
+  }
+
+  const std::filesystem::path logPath_;
+  const std::filesystem::path rotatedLogPath_;
+};
+
+TEST_F(LoggingTest, setLogPathShouldWriteMessagesToTheGivenFile) {
+  setLogPath(logPath_);
+  enableDebugLogging(true);
+
+  getLogger()->debug("test message");
+  shutdownLogging();
+
+  EXPECT_NE(std::string::npos, readLog().find("[debug]: test message"));
+}
+
+TEST_F(LoggingTest, messagesBelowWarningShouldNotBeWrittenIfDebugLoggingIsOff) {
+  setLogPath(logPath_);
+  enableDebugLogging(false);
+
+  getLogger()->info("info message");
+  getLogger()->warn("warning message");
+  shutdownLogging();
+
+  auto log = readLog();
+  EXPECT_EQ(std::string::npos, log.find("info message"));
+  EXPECT_NE(std::string::npos, log.find("warning message"));
+}
+
+TEST_F(LoggingTest, errorMessagesShouldBeFlushedImmediately) {
+  setLogPath(logPath_);
+
+  getLogger()->error("error message");
+
+  // Less than the periodic flush interval.
+  EXPECT_TRUE(
+      waitForLogToContain("error message", std::chrono::milliseconds(500)));
+}
+
+TEST_F(LoggingTest, setLogPathShouldSupportDiscardingTheOldestMessages) {
+  LogFileOptions options;
+  options.overflowPolicy = LogOverflowPolicy::discardOldest;
+  setLogPath(logPath_, options);
+  enableDebugLogging(true);
+
+  for (int i = 0; i < 100000; ++i) {
+    getLogger()->trace("message {}", i);
+  }
+  shutdownLogging();
+
+  // Whatever else is discarded, the newest message is always written.
+  EXPECT_NE(std::string::npos, readLog().find("message 99999"));
+}
+
+TEST_F(LoggingTest, setLogPathShouldNotTouchAnExistingLogFile) {
+  writeFile(logPath_, "previous session");
+
+  setLogPath(logPath_);
+
+  EXPECT_EQ("previous session", readLog());
+  EXPECT_FALSE(std::filesystem::exists(rotatedLogPath_));
+}
+
+TEST_F(LoggingTest, writingTheFirstMessageShouldRotateAnExistingLogFile) {
+  writeFile(logPath_, "previous session");
+
+  setLogPath(logPath_);
+  getLogger()->warn("test message");
+  shutdownLogging();
+
+  EXPECT_EQ("previous session", readGzipFile(rotatedLogPath_));
+  auto log = readLog();
+  EXPECT_EQ(std::string::npos, log.find("previous session"));
+  EXPECT_NE(std::string::npos, log.find("test message"));
+}
+
+TEST_F(LoggingTest,
+       messagesShouldBeAppendedToAnExistingLogFileIfItCannotBeRotated) {
+  writeFile(logPath_, "previous session\n");
+  // A non-empty directory can't be replaced by the rotated log file.
+  std::filesystem::create_directory(rotatedLogPath_);
+  writeFile(rotatedLogPath_ / "file.txt", "");
+
+  LogFileOptions options;
+  options.maxRotatedFiles = 1;
+  setLogPath(logPath_, options);
+  getLogger()->warn("first message");
+  getLogger()->warn("second message");
+  shutdownLogging();
+  std::filesystem::remove_all(rotatedLogPath_);
+
+  auto log = readLog();
+  EXPECT_EQ(0, log.find("previous session"));
+  EXPECT_NE(std::string::npos, log.find("first message"));
+  EXPECT_NE(std::string::npos, log.find("second message"));
+}
+
+TEST_F(LoggingTest, theLogFileShouldBeRotatedWhenItExceedsTheMaximumSize) {
+  LogFileOptions options;
+  options.maxFileSize = 1024;
+  setLogPath(logPath_, options);
+
+  for (int i = 0; i < 100; ++i) {
+    getLogger()->warn("message {}", i);
+  }
+  shutdownLogging();
+
+  EXPECT_LE(std::filesystem::file_size(logPath_), options.maxFileSize);
+  EXPECT_NE(std::string::npos, readLog().find("message 99"));
+  EXPECT_NE(std::string::npos,
+            readGzipFile(rotatedLogPath_).find("[warning]: message"));
+}
+
+TEST_F(LoggingTest, onlyTheConfiguredNumberOfRotatedLogFilesShouldBeKept) {
+  LogFileOptions options;
+  options.maxFileSize = 1024;
+  options.maxRotatedFiles = 2;
+  setLogPath(logPath_, options);
+
+  for (int i = 0; i < 1000; ++i) {
+    getLogger()->warn("message {}", i);
+  }
+  shutdownLogging();
+
+  auto parentPath = logPath_.parent_path();
+  EXPECT_TRUE(
+      std::filesystem::exists(parentPath / "LOOT-logging-test.2.txt.gz"));
+  EXPECT_FALSE(
+      std::filesystem::exists(parentPath / "LOOT-logging-test.3.txt.gz"));
+  EXPECT_FALSE(std::filesystem::exists(parentPath / "LOOT-logging-test.1.txt"));
+}
+
+TEST_F(LoggingTest, setLogPathShouldReplaceAnExistingFileLogger) {
+  auto otherLogPath = logPath_.parent_path() / "LOOT-logging-test-2.txt";
+  setLogPath(otherLogPath);
+  setLogPath(logPath_);
+  enableDebugLogging(true);
+
+  getLogger()->info("test message");
+  shutdownLogging();
+
+  EXPECT_NE(std::string::npos, readLog().find("test message"));
+
+  std::filesystem::remove(otherLogPath);
+}
+}
+}
+
+#endif
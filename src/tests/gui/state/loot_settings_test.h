@@ -92,6 +92,7 @@ TEST_P(LootSettingsTest, defaultConstructorShouldSetDefaultValues) {
   EXPECT_FALSE(settings_.isDebugLoggingEnabled());
   EXPECT_TRUE(settings_.updateMasterlist());
   EXPECT_TRUE(settings_.isLootUpdateCheckEnabled());
+  EXPECT_EQ(512, settings_.getInactiveGamesMemoryBudget());
   EXPECT_EQ("auto", settings_.getGame());
   EXPECT_EQ("auto", settings_.getLastGame());
   EXPECT_TRUE(settings_.getLastVersion().empty());
@@ -199,6 +200,7 @@ TEST_P(LootSettingsTest, loadingShouldReadFromATomlFile) {
   out << "enableDebugLogging = true" << endl
       << "updateMasterlist = true" << endl
       << "enableLootUpdateCheck = false" << endl
+      << "inactiveGamesMemoryBudget = 256" << endl
       << "game = \"Oblivion\"" << endl
       << "lastGame = \"Skyrim\"" << endl
       << "language = \"fr\"" << endl
@@ -231,6 +233,7 @@ TEST_P(LootSettingsTest, loadingShouldReadFromATomlFile) {
   EXPECT_TRUE(settings_.isDebugLoggingEnabled());
   EXPECT_TRUE(settings_.updateMasterlist());
   EXPECT_FALSE(settings_.isLootUpdateCheckEnabled());
+  EXPECT_EQ(256, settings_.getInactiveGamesMemoryBudget());
   EXPECT_EQ("Oblivion", settings_.getGame());
   EXPECT_EQ("Skyrim", settings_.getLastGame());
   EXPECT_EQ("0.7.1", settings_.getLastVersion());
@@ -500,6 +503,7 @@ TEST_P(LootSettingsTest, saveShouldWriteSettingsToPassedTomlFile) {
   settings_.enableDebugLogging(true);
   settings_.updateMasterlist(true);
   settings_.enableLootUpdateCheck(false);
+  settings_.setInactiveGamesMemoryBudget(128);
   settings_.setDefaultGame(game);
   settings_.storeLastGame(lastGame);
   settings_.setLanguage(language);
@@ -519,6 +523,7 @@ TEST_P(LootSettingsTest, saveShouldWriteSettingsToPassedTomlFile) {
   EXPECT_TRUE(settings.isDebugLoggingEnabled());
   EXPECT_TRUE(settings.updateMasterlist());
   EXPECT_FALSE(settings.isLootUpdateCheckEnabled());
+  EXPECT_EQ(128, settings.getInactiveGamesMemoryBudget());
   EXPECT_EQ(game, settings.getGame());
   EXPECT_EQ(lastGame, settings.getLastGame());
   EXPECT_EQ(language, settings.getLanguage());
@@ -25,11 +25,13 @@ along with LOOT.  If not, see
 #define LOOT_TESTS_GUI_TEST_HELPERS
 
 #include <filesystem>
+#include <fstream>
 #include <string>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <loot/api.h>
 
 namespace loot {
 namespace test {
@@ -45,6 +47,49 @@ void touch(const std::filesystem::path& path) {
   std::ofstream out(path);
   out.close();
 }
+
+class TestPlugin : public PluginInterface {
+public:
+  TestPlugin(std::string name,
+             std::optional<uint32_t> crc = std::optional<uint32_t>()) :
+      name_(name), crc_(crc) {}
+
+  std::string GetName() const override { return name_; }
+
+  float GetHeaderVersion() const { return 0.0f; }
+
+  std::optional<std::string> GetVersion() const {
+    return std::optional<std::string>();
+  }
+
+  std::vector<std::string> GetMasters() const {
+    return std::vector<std::string>();
+  }
+
+  std::vector<Tag> GetBashTags() const { return std::vector<Tag>(); }
+
+  std::optional<uint32_t> GetCRC() const { return crc_; }
+
+  bool IsMaster() const { return false; }
+
+  bool IsLightMaster() const { return false; }
+
+  bool IsLightPlugin() const { return false; }
+
+  bool IsValidAsLightMaster() const { return false; }
+
+  bool IsValidAsLightPlugin() const { return false; }
+
+  bool IsEmpty() const { return false; }
+
+  bool LoadsArchive() const { return false; }
+
+  bool DoFormIDsOverlap(const PluginInterface& plugin) const { return false; }
+
+private:
+  const std::string name_;
+  const std::optional<uint32_t> crc_;
+};
 }
 }
 